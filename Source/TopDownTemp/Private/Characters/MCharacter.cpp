@@ -15,7 +15,11 @@
 #include "Abilities/MGameplayAbility.h"
 #include "Components/MAbilitySystemComponent.h"
 #include "Framework/MGameMode.h"
+#include "Managers/MCommunicationManager.h"
 #include "Managers/MMetadataManager.h"
+#include "Managers/MPerceptionSubsystem.h"
+#include "Managers/MSquadSubsystem.h"
+#include "Managers/MVirtualSimulationSubsystem.h"
 #include "Managers/SaveManager/MSaveManager.h"
 #include "Managers/MWorldSaveTypes.h"
 #include "Managers/MWorldGenerator.h"
@@ -82,6 +86,10 @@ AMCharacter::AMCharacter(const FObjectInitializer& ObjectInitializer)
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
 
+	CosmeticTick.bCanEverTick = true;
+	CosmeticTick.bStartWithTickEnabled = true;
+	CosmeticTick.TickGroup = TG_PostPhysics;
+
 	// Configure collision
 	if (const auto PrimitiveRoot = Cast<UPrimitiveComponent>(RootComponent))
 	{
@@ -133,41 +141,95 @@ void AMCharacter::OnMovedIn(AMOutpostHouse* NewHouse)
 	OnMovedInDelegate.Broadcast(NewHouse);
 }
 
+#if !UE_BUILD_SHIPPING
+int64 AMCharacter::CosmeticTicksNumber = 0;
+int64 AMCharacter::IdleSkipsNumber = 0;
+#endif
+
+void FMCharacterCosmeticTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (IsValid(Target) && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->TickCosmetic(DeltaTime);
+	}
+}
+
+FString FMCharacterCosmeticTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[TickCosmetic]") : TEXT("FMCharacterCosmeticTickFunction");
+}
+
+FName FMCharacterCosmeticTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return Target ? Target->GetClass()->GetFName() : NAME_None;
+}
+
 void AMCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	if (StateModelComponent->GetIsDirty() && HasAuthority())
+	if (HasAuthority())
 	{
-		StateModelComponent->CleanDirty();
-		if (auto* SkeletalMesh = GetComponentByClass<USkeletalMeshComponent>())
+		// Replicated, so it's decided here at full rate whatever the cosmetic phase rate is
+		const auto Velocity = GetVelocity();
+		auto GazeVector = ForcedGazeVector.IsZero() ? (Velocity.IsZero() ? CurrentGazeVector : Velocity) : ForcedGazeVector;
+		GazeVector.Z = 0;
+		StateModelComponent->SetIsReversing(abs(UM2DRepresentationBlueprintLibrary::GetDeflectionAngle(GazeVector, Velocity)) > 90.f);
+
+		if (StateModelComponent->GetIsDirty())
 		{
-			if (auto* AnimInstance = SkeletalMesh->GetAnimInstance())
+			StateModelComponent->CleanDirty();
+			if (auto* SkeletalMesh = GetComponentByClass<USkeletalMeshComponent>())
 			{
-				AnimInstance->UpdateAnimation(0, false);
+				if (auto* AnimInstance = SkeletalMesh->GetAnimInstance())
+				{
+					AnimInstance->UpdateAnimation(0, false);
+				}
+				OnStateModelUpdatedDelegate.Broadcast(StateModelComponent);
 			}
-			OnStateModelUpdatedDelegate.Broadcast(StateModelComponent);
+			UpdateAnimation();
+			UpdateAttackPuddleTick();
+		}
+		if (StatsModelComponent->GetIsDirty())
+		{
+			StatsModelComponent->CleanDirty();
 		}
-		UpdateAnimation();
-	}
-	if (StatsModelComponent->GetIsDirty() && HasAuthority())
-	{
-		StatsModelComponent->CleanDirty();
 	}
 
 	UpdateLastNonZeroDirection();
+}
 
-	CurrentGazeVector = ForcedGazeVector.IsZero() ? (GetVelocity().IsZero() ? CurrentGazeVector : GetVelocity()) : ForcedGazeVector;
-	CurrentGazeVector.Z = 0;
+void AMCharacter::TickCosmetic(float DeltaSeconds)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMCharacter::TickCosmetic);
+
+	UpdateCosmeticTickInterval();
 
-	if (abs(UM2DRepresentationBlueprintLibrary::GetDeflectionAngle(CurrentGazeVector, GetVelocity())) > 90.f)
+	const auto Velocity = GetVelocity();
+	FVector CameraVector = FVector::ZeroVector;
+	if (const auto PlayerController = GetWorld()->GetFirstPlayerController(); PlayerController && PlayerController->PlayerCameraManager)
 	{
-		StateModelComponent->SetIsReversing(true);
+		CameraVector = PlayerController->PlayerCameraManager->GetActorForwardVector();
 	}
-	else
+
+	// Idle: the gaze, the rotation and the sprites would be exactly the same
+	if (bCosmeticUpdated && Velocity == LastCosmeticVelocity && ForcedGazeVector == LastCosmeticForcedGaze && CameraVector == LastCosmeticCameraVector)
 	{
-		StateModelComponent->SetIsReversing(false);
+#if !UE_BUILD_SHIPPING
+		++IdleSkipsNumber;
+#endif
+		return;
 	}
+#if !UE_BUILD_SHIPPING
+	++CosmeticTicksNumber;
+#endif
+	LastCosmeticVelocity = Velocity;
+	LastCosmeticForcedGaze = ForcedGazeVector;
+	LastCosmeticCameraVector = CameraVector;
+	bCosmeticUpdated = true;
+
+	CurrentGazeVector = ForcedGazeVector.IsZero() ? (Velocity.IsZero() ? CurrentGazeVector : Velocity) : ForcedGazeVector;
+	CurrentGazeVector.Z = 0;
 
 	if (IsPlayerControlled())
 	{
@@ -179,7 +241,83 @@ void AMCharacter::Tick(float DeltaSeconds)
 	}
 	if (FaceCameraComponent) //TODO: This logic is related to M2DRepresentationComponent, might be legacy
 	{
-		FaceCameraComponent->SetMeshByGazeAndVelocity(CurrentGazeVector, GetVelocity());
+		FaceCameraComponent->SetMeshByGazeAndVelocity(CurrentGazeVector, Velocity);
+	}
+}
+
+void AMCharacter::UpdateCosmeticTickInterval()
+{
+	float Interval = 0.f;
+	if (!IsPlayerControlled())
+	{
+		if (!WasRecentlyRendered(HiddenCosmeticTickInterval))
+		{
+			Interval = HiddenCosmeticTickInterval;
+		}
+		else if (GetClosestPlayerDistanceSquared(true) > FMath::Square(SignificantDistance))
+		{
+			Interval = FarCosmeticTickInterval;
+		}
+	}
+
+	if (CosmeticTick.TickInterval != Interval)
+	{
+		CosmeticTick.UpdateTickIntervalAndCoolDown(Interval);
+	}
+}
+
+float AMCharacter::GetClosestPlayerDistanceSquared(bool bLocalOnly) const
+{
+	float Result = TNumericLimits<float>::Max();
+	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const auto PlayerController = It->Get();
+		if (!PlayerController || (bLocalOnly && !PlayerController->IsLocalController()))
+			continue;
+
+		if (const auto PlayerPawn = PlayerController->GetPawn())
+		{
+			Result = FMath::Min(Result, static_cast<float>(FVector::DistSquared2D(PlayerPawn->GetActorLocation(), GetActorLocation())));
+		}
+	}
+	return Result;
+}
+
+void AMCharacter::SetActorTickEnabled(bool bEnabled)
+{
+	Super::SetActorTickEnabled(bEnabled);
+
+	// E.g. disabled by UMIsActiveCheckerComponent, both phases stop
+	if (CosmeticTick.bCanEverTick && !IsTemplate())
+	{
+		CosmeticTick.SetTickFunctionEnable(bEnabled);
+	}
+}
+
+void AMCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (CosmeticTick.bCanEverTick)
+		{
+			CosmeticTick.Target = this;
+			CosmeticTick.SetTickFunctionEnable(CosmeticTick.bStartWithTickEnabled || CosmeticTick.IsTickFunctionEnabled());
+			CosmeticTick.RegisterTickFunction(GetLevel());
+		}
+	}
+	else if (CosmeticTick.IsTickFunctionRegistered())
+	{
+		CosmeticTick.UnRegisterTickFunction();
+	}
+}
+
+void AMCharacter::UpdateAttackPuddleTick()
+{
+	if (AttackPuddleComponent && StateModelComponent)
+	{
+		AttackPuddleComponent->SetComponentTickEnabled(StateModelComponent->GetIsFighting());
 	}
 }
 
@@ -190,6 +328,7 @@ void AMCharacter::PostInitializeComponents()
 	if (StateModelComponent && !HasAuthority())
 	{
 		StateModelComponent->OnDirtyDelegate.AddDynamic(this, &AMCharacter::UpdateAnimation);
+		StateModelComponent->OnDirtyDelegate.AddDynamic(this, &AMCharacter::UpdateAttackPuddleTick);
 	}
 	if (FaceCameraComponent)
 	{
@@ -199,10 +338,20 @@ void AMCharacter::PostInitializeComponents()
 
 FMCharacterSaveData AMCharacter::GetSaveData() const
 {
+	// A disabled mob keeps walking in the simulation, the actor is only moved when it crosses a block border
+	FVector Location = GetActorLocation();
+	if (const auto VirtualSimulationSubsystem = GetWorld()->GetSubsystem<UMVirtualSimulationSubsystem>())
+	{
+		if (const auto SimulatedLocation = VirtualSimulationSubsystem->FindSimulatedLocation(this))
+		{
+			Location = *SimulatedLocation;
+		}
+	}
+
 	// Start from the base and compose structs upwards
 	FActorSaveData ActorSaveData = {
 		GetClass(),
-		GetActorLocation(),
+		Location,
 		GetActorRotation(),
 		AMGameMode::GetMetadataManager(this)->Find(FName(GetName()))->Uid,
 		UMSaveManager::GetSaveDataForComponents(this)
@@ -268,6 +417,25 @@ void AMCharacter::BeginPlay()
 
 	GetCharacterMovement()->MaxWalkSpeed = StatsModelComponent->GetWalkSpeed();
 	//TODO: Fix the issue when the stat is updated but movement component is not
+
+	if (const auto PerceptionSubsystem = GetWorld()->GetSubsystem<UMPerceptionSubsystem>())
+	{
+		PerceptionSubsystem->RegisterCharacter(this);
+	}
+}
+
+void AMCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto PerceptionSubsystem = GetWorld()->GetSubsystem<UMPerceptionSubsystem>())
+	{
+		PerceptionSubsystem->UnregisterCharacter(this);
+	}
+	if (const auto SquadSubsystem = GetWorld()->GetSubsystem<UMSquadSubsystem>())
+	{
+		SquadSubsystem->Leave(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMCharacter::AddCharacterAbilities()
@@ -347,6 +515,23 @@ void AMCharacter::PossessedBy(AController* NewController)
 
 	// ASC MixedMode replication requires that the ASC Owner's Owner be the Controller.
 	SetOwner(NewController);
+
+	// Attitudes are resolved by the controller
+	if (const auto CommunicationManager = AMGameMode::GetCommunicationManager(this))
+	{
+		CommunicationManager->InvalidateAttitudes(this);
+	}
+}
+
+void AMCharacter::UnPossessed()
+{
+	// Also the way out of the cache for the destroyed characters
+	if (const auto CommunicationManager = AMGameMode::GetCommunicationManager(this))
+	{
+		CommunicationManager->InvalidateAttitudes(this);
+	}
+
+	Super::UnPossessed();
 }
 
 void AMCharacter::Server_PlayMontage_Implementation(UAnimMontage* AnimMontage)
@@ -384,8 +569,16 @@ int32 AMCharacter::GetAbilityLevel(EMAbilityInputID AbilityID) const
 
 void AMCharacter::OnEnabled_Implementation()
 {
+	if (const auto VirtualSimulationSubsystem = GetWorld()->GetSubsystem<UMVirtualSimulationSubsystem>())
+	{
+		VirtualSimulationSubsystem->Devirtualize(this);
+	}
 }
 
 void AMCharacter::OnDisabled_Implementation()
 {
+	if (const auto VirtualSimulationSubsystem = GetWorld()->GetSubsystem<UMVirtualSimulationSubsystem>())
+	{
+		VirtualSimulationSubsystem->Virtualize(this);
+	}
 }
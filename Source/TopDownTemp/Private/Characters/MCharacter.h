@@ -24,6 +24,31 @@ class AMOutpostHouse;
 struct FMCharacterSaveData;
 class UMBuffManagerComponent;
 
+class AMCharacter;
+
+/** Cosmetic part of the character tick: gaze, rotation and the 2D representation.\n
+ * Runs after physics. On clients, at a rate depending on how significant the character is for the local player.
+ * Always at full rate on the authority, as it also sets replicated state */
+USTRUCT()
+struct FMCharacterCosmeticTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	AMCharacter* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMCharacterCosmeticTickFunction> : public TStructOpsTypeTraitsBase2<FMCharacterCosmeticTickFunction>
+{
+	enum { WithCopy = false };
+};
+
 /** Called when the character moves into a house (or any other kind of place to live) */
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnMovedInDelegate, const AMOutpostHouse* NewHouse);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnStateModelUpdated, const UMStateModelComponent* StateModel);
@@ -88,9 +113,18 @@ public:
 
 	void OnMovedOut() { House = nullptr; }
 
-	// Called every frame.
+	/** Authority phase. Called every frame, before physics */
 	virtual void Tick(float DeltaSeconds) override;
 
+	/** Cosmetic phase, see FMCharacterCosmeticTickFunction. Skipped entirely while nothing affecting the look changed */
+	void TickCosmetic(float DeltaSeconds);
+
+	/** Significance of the character: the squared 2D distance to the closest player pawn. Max float if there is none.\n
+	 * bLocalOnly is for what only the local players see, e.g. the look. The server counts every player for gameplay */
+	float GetClosestPlayerDistanceSquared(bool bLocalOnly) const;
+
+	virtual void SetActorTickEnabled(bool bEnabled) override;
+
 	virtual void PostInitializeComponents() override;
 
 	/** Start from the base (FActorSaveData -> might add more in between -> FMCharacterSaveData).\n
@@ -118,6 +152,8 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
 	UFUNCTION(BlueprintNativeEvent)
@@ -128,6 +164,17 @@ protected:
 
 	virtual void PossessedBy(AController* NewController) override;
 
+	virtual void UnPossessed() override;
+
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+	/** Picks the cosmetic tick rate by the distance to the closest local player and the visibility */
+	void UpdateCosmeticTickInterval();
+
+	/** The puddle only has to follow the gaze while fighting */
+	UFUNCTION()
+	void UpdateAttackPuddleTick();
+
 	/** Representation (collection of sprites) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	UM2DRepresentationComponent* FaceCameraComponent;
@@ -194,6 +241,36 @@ protected:
 	UPROPERTY()
 	AMOutpostHouse* House;
 
+// Tick phases
+public: // For debugging
+#if !UE_BUILD_SHIPPING
+	static int64 CosmeticTicksNumber;
+
+	static int64 IdleSkipsNumber;
+#endif
+
+	float GetCosmeticTickInterval() const { return CosmeticTick.TickInterval; }
+
+protected:
+	FMCharacterCosmeticTickFunction CosmeticTick;
+
+	/** Beyond this distance to the closest local player the cosmetic phase runs at FarCosmeticTickInterval */
+	UPROPERTY(EditDefaultsOnly, Category=Significance)
+	float SignificantDistance = 2000.f;
+
+	UPROPERTY(EditDefaultsOnly, Category=Significance)
+	float FarCosmeticTickInterval = 0.1f;
+
+	/** The cosmetic phase rate for characters not rendered recently */
+	UPROPERTY(EditDefaultsOnly, Category=Significance)
+	float HiddenCosmeticTickInterval = 0.25f;
+
+	/** What the last cosmetic update was done for. If nothing changed, the update is skipped */
+	FVector LastCosmeticVelocity = FVector::ZeroVector;
+	FVector LastCosmeticForcedGaze = FVector::ZeroVector;
+	FVector LastCosmeticCameraVector = FVector::ZeroVector;
+	bool bCosmeticUpdated = false;
+
 // Ability system
 public:
 	// Switch on AbilityID to return individual ability levels.
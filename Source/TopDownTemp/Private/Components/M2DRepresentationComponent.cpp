@@ -1,6 +1,7 @@
 #include "M2DRepresentationComponent.h"
 
 #include "Helpers/M2DRepresentationBlueprintLibrary.h"
+#include "Algo/Count.h"
 #include "M2DShadowControllerComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "PaperSpriteComponent.h"
@@ -9,6 +10,7 @@
 #include "Characters/MMemoryator.h"
 #include "Components/WidgetComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Managers/MColorTransitionSubsystem.h"
 
 UM2DRepresentationComponent::UM2DRepresentationComponent(const FObjectInitializer& ObjectInitializer) :
 	Super(ObjectInitializer),
@@ -34,6 +36,16 @@ void UM2DRepresentationComponent::BeginPlay()
 	CameraManager = GetWorld()->GetFirstPlayerController()->PlayerCameraManager;
 }
 
+void UM2DRepresentationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto ColorTransitionSubsystem = GetWorld()->GetSubsystem<UMColorTransitionSubsystem>())
+	{
+		ColorTransitionSubsystem->StopTransition(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UM2DRepresentationComponent::SetUpSprites()
 {
 	CapsuleComponentArray.Empty();
@@ -52,6 +64,9 @@ void UM2DRepresentationComponent::SetUpSprites()
 			CapsuleComponentArray.Add(CapsuleComponent);
 		}
 	}
+
+	// Colors are applied only during transitions, so the sprites found again must get the current one right away
+	ApplyColor();
 }
 
 void UM2DRepresentationComponent::CreateShadowTwins()
@@ -121,8 +136,6 @@ void UM2DRepresentationComponent::TickComponent(float DeltaTime, ELevelTick Tick
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	FaceToCamera();
-
-	InterpolateColor(DeltaTime);
 }
 
 void UM2DRepresentationComponent::SetMeshByGazeAndVelocity(const FVector& IN_Gaze, const FVector& IN_Velocity,
@@ -144,7 +157,14 @@ void UM2DRepresentationComponent::SetMeshByGazeAndVelocity(const FVector& IN_Gaz
 
 void UM2DRepresentationComponent::SetColor(const FLinearColor& Color)
 {
+	if (DesiredColor == Color)
+		return;
+
 	DesiredColor = Color;
+	if (const auto ColorTransitionSubsystem = GetWorld()->GetSubsystem<UMColorTransitionSubsystem>())
+	{
+		ColorTransitionSubsystem->StartTransition(this);
+	}
 }
 
 #if WITH_EDITOR
@@ -161,13 +181,34 @@ void UM2DRepresentationComponent::PostEditChangeProperty(FPropertyChangedEvent&
 }
 #endif
 
-void UM2DRepresentationComponent::InterpolateColor(const float DeltaTime)
+bool UM2DRepresentationComponent::InterpolateColor(const float DeltaTime)
 {
 	CurrentColor.R = UKismetMathLibrary::FInterpTo(CurrentColor.R, DesiredColor.R, DeltaTime, ColorChangingSpeed);
 	CurrentColor.G = UKismetMathLibrary::FInterpTo(CurrentColor.G, DesiredColor.G, DeltaTime, ColorChangingSpeed);
 	CurrentColor.B = UKismetMathLibrary::FInterpTo(CurrentColor.B, DesiredColor.B, DeltaTime, ColorChangingSpeed);
 	CurrentColor.A = UKismetMathLibrary::FInterpTo(CurrentColor.A, DesiredColor.A, DeltaTime, ColorChangingSpeed);
 
+	// Snap the tail of the interpolation, otherwise it would never end
+	const bool bReached = CurrentColor.Equals(DesiredColor, 1.f / 255.f);
+	if (bReached)
+	{
+		CurrentColor = DesiredColor;
+	}
+
+	ApplyColor();
+	return !bReached;
+}
+
+int32 UM2DRepresentationComponent::GetColoredSpritesNumber() const
+{
+	return Algo::CountIf(RenderComponentArray, [](const UMeshComponent* RenderComponent)
+	{
+		return Cast<UPaperFlipbookComponent>(RenderComponent) || Cast<UPaperSpriteComponent>(RenderComponent);
+	});
+}
+
+void UM2DRepresentationComponent::ApplyColor()
+{
 	for (const auto RenderComponent : RenderComponentArray)
 	{
 		if (const auto Flipbook = Cast<UPaperFlipbookComponent>(RenderComponent))
@@ -29,13 +29,22 @@ public:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	void SetMeshByGazeAndVelocity(const FVector& IN_Gaze, const FVector& IN_Velocity, const FName& Tag = "");
 
+	/** Starts a smooth transition to the color, see UMColorTransitionSubsystem */
 	UFUNCTION(BlueprintCallable)
 	void SetColor(const FLinearColor& Color);
 
+	/** Moves the current color toward the desired one. Returns false once it's reached */
+	bool InterpolateColor(float DeltaTime);
+
+	/** Number of render components that take the color */
+	int32 GetColoredSpritesNumber() const;
+
 	UPROPERTY(Category=Rendering, EditAnywhere, BlueprintReadWrite)
 	bool bFaceToCamera = true;
 
@@ -62,7 +71,7 @@ private:
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
-	void InterpolateColor(float DeltaTime);
+	void ApplyColor();
 
 	UPROPERTY() 
 	TArray<UCapsuleComponent*> CapsuleComponentArray; // TODO: It's no longer used, should be removed
@@ -2,26 +2,17 @@
 
 #include "ComponentUtils.h"
 #include "PaperFlipbookComponent.h"
-#include "Engine/DirectionalLight.h"
-#include "Kismet/GameplayStatics.h"
 #include "MRotatableFlipbookComponent.h"
+#include "Managers/MShadowSubsystem.h"
 #include "Helpers/M2DRepresentationBlueprintLibrary.h"
 
 UM2DShadowControllerComponent::UM2DShadowControllerComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
-	, pDirectionalLight(nullptr)
+	, ShadowSubsystem(nullptr)
 	, PossessedShadowComponent(nullptr)
 {
-	// We consider there is no light source in the blueprint editor
-#ifdef WITH_EDITOR
-	if (!GIsPlayInEditorWorld)
-	{
-		return;
-	}
-#endif
-
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = true;
+	// Turned toward the light by UMShadowSubsystem, no need to tick
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 void UM2DShadowControllerComponent::Possess(UMeshComponent* ShadowComponentToPossess, UMeshComponent* RenderComponent)
@@ -35,9 +26,12 @@ void UM2DShadowControllerComponent::Possess(UMeshComponent* ShadowComponentToPos
 #endif
 
 	PossessedShadowComponent = ShadowComponentToPossess;
+	// Keeps the world rotation set by the subsystem when the owner turns
+	PossessedShadowComponent->SetUsingAbsoluteRotation(true);
 
-	pDirectionalLight = Cast<ADirectionalLight>(UGameplayStatics::GetActorOfClass(this, ADirectionalLight::StaticClass()));
-	check(pDirectionalLight);
+	ShadowSubsystem = GetWorld()->GetSubsystem<UMShadowSubsystem>();
+	check(ShadowSubsystem);
+	ShadowSubsystem->RegisterShadow(this);
 
 	if (const auto FlipbookComponent = Cast<UMRotatableFlipbookComponent>(RenderComponent))
 	{
@@ -52,22 +46,35 @@ void UM2DShadowControllerComponent::Possess(UMeshComponent* ShadowComponentToPos
 	PossessedShadowComponent->SetVisibility(false);
 }
 
-void UM2DShadowControllerComponent::TickComponent(float DeltaTime, ELevelTick TickType,
-                                                  FActorComponentTickFunction* ThisTickFunction)
+void UM2DShadowControllerComponent::SetShadowRotation(const FRotator& ShadowRotation)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	// Rotate the mesh perpendicularly to the direction light source
-	if (PossessedShadowComponent && pDirectionalLight)
+	if (PossessedShadowComponent)
 	{
-		auto ShadowRotation = pDirectionalLight->GetTransform().Rotator();
-		ShadowRotation.Pitch = 0.f;
-		ShadowRotation.Yaw += 90.f;
-		ShadowRotation.Roll = 0.f;
 		PossessedShadowComponent->SetWorldRotation(ShadowRotation);
 	}
 }
 
+void UM2DShadowControllerComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Registered again after being unregistered
+	if (ShadowSubsystem && PossessedShadowComponent)
+	{
+		ShadowSubsystem->RegisterShadow(this);
+	}
+}
+
+void UM2DShadowControllerComponent::OnUnregister()
+{
+	if (ShadowSubsystem)
+	{
+		ShadowSubsystem->UnregisterShadow(this);
+	}
+
+	Super::OnUnregister();
+}
+
 void UM2DShadowControllerComponent::OnPossessedMeshUpdated(
 	UPaperFlipbook* Flipbook,
 	float PlaybackPosition,
@@ -94,7 +101,7 @@ void UM2DShadowControllerComponent::OnPossessedMeshUpdated(
 		}
 
 		// If the camera observes the mesh from the opposite side, it should be mirrored
-		const auto angle = UM2DRepresentationBlueprintLibrary::GetCameraDeflectionAngle(this, pDirectionalLight->GetActorForwardVector());
+		const auto angle = UM2DRepresentationBlueprintLibrary::GetCameraDeflectionAngle(this, ShadowSubsystem->GetLightDirection());
 		if (abs(angle) > 90.f)
 		{
 			Scale.X *= -1;
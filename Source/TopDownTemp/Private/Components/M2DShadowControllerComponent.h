@@ -4,7 +4,7 @@
 #include "M2DShadowControllerComponent.generated.h"
 
 class UPaperFlipbook;
-class ADirectionalLight;
+class UMShadowSubsystem;
 
 /** Class responsible for positioning and configuring the invisible mesh that cast shadow */
 UCLASS()
@@ -16,10 +16,15 @@ public:
 
 	void Possess(UMeshComponent* ShadowComponentToPossess, UMeshComponent* RenderComponent);
 
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** Called by UMShadowSubsystem when the light turns */
+	void SetShadowRotation(const FRotator& ShadowRotation);
 
 private:
 
+	virtual void OnRegister() override;
+
+	virtual void OnUnregister() override;
+
 	UFUNCTION()
 	void OnPossessedMeshUpdated(
 		UPaperFlipbook* Flipbook,
@@ -30,7 +35,7 @@ private:
 		FVector Scale = FVector::OneVector);
 
 	UPROPERTY()
-	ADirectionalLight* pDirectionalLight;
+	UMShadowSubsystem* ShadowSubsystem;
 
 	UPROPERTY()
 	UMeshComponent* PossessedShadowComponent;
@@ -6,7 +6,7 @@
 #include "Components/BoxComponent.h"
 
 UMAttackPuddleComponent::UMAttackPuddleComponent()
-	: DynamicMaterialInterface(nullptr), DynamicMaterial(nullptr)
+	: DynamicMaterialInterface(nullptr), DynamicMaterial(nullptr), pRepresentationComponent(nullptr)
 	, Angle(0)
 	, Length(0)
 {
@@ -19,8 +19,12 @@ UMAttackPuddleComponent::UMAttackPuddleComponent()
 
 	bCanEverAffectNavigation = false;
 
+	// The rotation follows the gaze, not the owner. Also lets UpdateRotation() skip when the gaze didn't change
+	SetUsingAbsoluteRotation(true);
+
+	// Enabled by the owner only while it's fighting, see AMCharacter::UpdateAttackPuddleTick()
 	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UMAttackPuddleComponent::BeginPlay()
@@ -44,6 +48,11 @@ void UMAttackPuddleComponent::BeginPlay()
 	{
 		DynamicMaterial = CreateDynamicMaterialInstance(0, DynamicMaterialInterface);
 	}
+
+	if (const auto OwnerActor = GetOwner())
+	{
+		pRepresentationComponent = OwnerActor->FindComponentByClass<UM2DRepresentationComponent>();
+	}
 }
 
 void UMAttackPuddleComponent::SetLength(float IN_Length)
@@ -118,15 +127,33 @@ void UMAttackPuddleComponent::SetAngle(float Value)
 
 void UMAttackPuddleComponent::UpdateRotation()
 {
-	if (const auto OwnerActor = GetOwner())
+	if (!pRepresentationComponent)
+		return;
+
+	const float Yaw = FRotationMatrix::MakeFromX(pRepresentationComponent->LastValidGaze).Rotator().Yaw - Angle / 2.f;
+	if (LastAppliedYaw.IsSet() && FMath::IsNearlyEqual(LastAppliedYaw.GetValue(), Yaw))
+		return;
+	LastAppliedYaw = Yaw;
+
+	SetWorldRotation(FRotator(0.f, 90.f, -90.f)); // Rotate to lay on the ground
+	AddWorldRotation(FRotator(0.f, Yaw, 0.f)); // Actual rotation shifted to face the segment center
+}
+
+FMMeleeSector UMAttackPuddleComponent::GetSector() const
+{
+	FMMeleeSector Sector;
+	Sector.Origin = FVector2D(GetComponentLocation());
+	Sector.Length = Length;
+	Sector.Angle = Angle;
+	if (pRepresentationComponent)
 	{
-		if (const auto RepresentationComponent = OwnerActor->FindComponentByClass<UM2DRepresentationComponent>())
+		const auto Gaze = FVector2D(pRepresentationComponent->LastValidGaze).GetSafeNormal();
+		if (!Gaze.IsZero())
 		{
-			SetWorldRotation(FRotator(0.f, 90.f, -90.f)); // Rotate to lay on the ground
-			AddWorldRotation(FRotator(0.f, FRotationMatrix::MakeFromX(RepresentationComponent->LastValidGaze).Rotator().Yaw, 0.f)); // Actual rotation
-			AddWorldRotation(FRotator(0.f, Angle / -2.f, 0.f)); // Shift to face the the segment center
+			Sector.Direction = Gaze;
 		}
 	}
+	return Sector;
 }
 
 void UMAttackPuddleComponent::TickComponent(float DeltaTime, ELevelTick TickType,
@@ -134,6 +161,7 @@ void UMAttackPuddleComponent::TickComponent(float DeltaTime, ELevelTick TickType
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Outside of attack windows the gaze rarely changes, so it's mostly a comparison
 	UpdateRotation();
 }
 
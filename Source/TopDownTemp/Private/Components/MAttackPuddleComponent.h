@@ -1,9 +1,11 @@
 #pragma once
 
 #include "PaperSpriteComponent.h"
+#include "Helpers/MMeleeHitQuery.h"
 #include "MAttackPuddleComponent.generated.h"
 
 class UBoxComponent;
+class UM2DRepresentationComponent;
 //TODO: Hide the Sprite category, because there's no difference which to use.
 /** Component represents the zone of the attack */
 UCLASS(BlueprintType, Blueprintable, HideCategories=(Materials))
@@ -24,8 +26,13 @@ public:
 	UFUNCTION()
 	void SetAngle(float Value);
 
+	/** Turns the puddle along the owner's gaze. Does nothing if neither the gaze nor the angle changed since the last call */
 	void UpdateRotation();
 
+	/** The zone of the attack as it is now, for MMeleeHitQuery. Doesn't depend on the puddle's rotation */
+	FMMeleeSector GetSector() const;
+
+	/** Per target version of the check. Combat uses MMeleeHitQuery instead, keep it for the blueprints and comparison */
 	UFUNCTION(BlueprintCallable)
 	bool IsCircleWithin(const FVector& Center, float Radius) const;
 
@@ -51,8 +58,14 @@ protected:
 	UPROPERTY()
 	UMaterialInstanceDynamic* DynamicMaterial;
 
+	UPROPERTY()
+	UM2DRepresentationComponent* pRepresentationComponent;
+
 	float Angle;
 
 	float Length;
 
+	/** Yaw the puddle was turned to by the last UpdateRotation() */
+	TOptional<float> LastAppliedYaw;
+
 };
@@ -14,8 +14,9 @@ UMInventoryComponent::UMInventoryComponent(const FObjectInitializer& ObjectIniti
 
 void UMInventoryComponent::Initialize(int IN_SlotsNumber, const TArray<FItem>& StartingItems)
 {
-	Slots.Empty();
-	Slots.AddDefaulted(IN_SlotsNumber);
+	Slots.Items.Empty();
+	Slots.Items.AddDefaulted(IN_SlotsNumber);
+	Slots.MarkArrayDirty();
 	for (const auto& Item : StartingItems)
 	{
 		if (Item.ID <= 0)
@@ -27,7 +28,7 @@ void UMInventoryComponent::Initialize(int IN_SlotsNumber, const TArray<FItem>& S
 TArray<FItem> UMInventoryComponent::GetItemCopies(bool bSkipEmpty) const
 {
 	TArray<FItem> Result;
-	for (const auto& Slot : Slots)
+	for (const auto& Slot : Slots.Items)
 	{
 		if (!bSkipEmpty || (bSkipEmpty && Slot.Item.Quantity != 0))
 		{
@@ -39,9 +40,9 @@ TArray<FItem> UMInventoryComponent::GetItemCopies(bool bSkipEmpty) const
 
 FItem UMInventoryComponent::GetItemCopy(int SlotNumberInArray) const
 {
-	if (Slots.Num() > SlotNumberInArray)
+	if (Slots.Items.Num() > SlotNumberInArray)
 	{
-		return Slots[SlotNumberInArray].Item;
+		return Slots.Items[SlotNumberInArray].Item;
 	}
 	check(false);
 	return {};
@@ -102,7 +103,7 @@ int GetCost(int ID, const UObject* WorldContextObject)
 TArray<FItem> UMInventoryComponent::MaxPriceCombination(int M)
 {
 	TArray<FItem> NonZeroItems;
-	for (const auto Slot : Slots)
+	for (const auto Slot : Slots.Items)
 	{
 		if (Slot.Item.Quantity > 0)
 		{
@@ -198,7 +199,7 @@ void UMInventoryComponent::SortSlots(TArray<FSlot>& IN_Slots, const UObject* Wor
 	//aaaaaa!z
 	if (const auto ItemsDataAsset = GetItemsDataAsset(WorldContextObject))
 	{
-		const auto ItemsData = ItemsDataAsset->ItemsData;
+		const auto& ItemsData = ItemsDataAsset->ItemsData;
 		IN_Slots.Sort([&ItemsData](const FSlot& A, const FSlot& B)
 		{
 			if (ItemsData.Num() <= A.Item.ID || ItemsData.Num() <= B.Item.ID || A.Item.ID <= 0 || B.Item.ID <= 0)
@@ -223,7 +224,7 @@ void UMInventoryComponent::SortItems(TArray<FItem>& IN_Items, const UObject* Wor
 {
 	if (const auto ItemsDataAsset = GetItemsDataAsset(WorldContextObject))
 	{
-		const auto ItemsData = ItemsDataAsset->ItemsData;
+		const auto& ItemsData = ItemsDataAsset->ItemsData;
 		IN_Items.Sort([&ItemsData](const FItem& A, const FItem& B)
 		{
 			if (ItemsData.Num() <= A.ID || ItemsData.Num() <= B.ID || A.ID <= 0 || B.ID <= 0)
@@ -283,7 +284,7 @@ void UMInventoryComponent::StoreItem(const FItem& ItemToStore)
 	if (!IsValid(pMGameInstance) || !pMGameInstance->ItemsDataAsset)
 		return;
 
-	const auto ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
+	const auto& ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
 	if (ItemToStore.ID >= ItemsData.Num() || ItemToStore.ID <= 0) // ID valid check
 	{
 		check(false);
@@ -292,7 +293,7 @@ void UMInventoryComponent::StoreItem(const FItem& ItemToStore)
 
 	// We consider any slot as empty if its Quantity is 0, no matter what ID it has
 
-	for (auto& Slot : Slots)
+	for (auto& Slot : Slots.Items)
 	{
 		if (Slot.Item.ID >= ItemsData.Num())
 		{
@@ -306,7 +307,7 @@ void UMInventoryComponent::StoreItem(const FItem& ItemToStore)
 			Slot.Item.Quantity += QuantityToAdd;
 			ItemLeft.Quantity -= QuantityToAdd;
 
-			Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+			OnSlotChanged(Slot);
 		}
 
 		if (ItemLeft.Quantity == 0)
@@ -317,7 +318,7 @@ void UMInventoryComponent::StoreItem(const FItem& ItemToStore)
 
 	if (ItemLeft.Quantity > 0)
 	{
-		for (auto& Slot : Slots)
+		for (auto& Slot : Slots.Items)
 		{
 			// Search for empty slots
 			if (Slot.Item.Quantity == 0)
@@ -327,7 +328,7 @@ void UMInventoryComponent::StoreItem(const FItem& ItemToStore)
 				Slot.Item.Quantity += QuantityToAdd;
 				ItemLeft.Quantity -= QuantityToAdd;
 
-				Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+				OnSlotChanged(Slot);
 			}
 
 			if (ItemLeft.Quantity == 0)
@@ -371,7 +372,7 @@ void UMInventoryComponent::StoreDraggedToAnySlot(FItem& DraggedItem)
 	if (!IsValid(pMGameInstance) || !pMGameInstance->ItemsDataAsset)
 		return;
 
-	const auto ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
+	const auto& ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
 	if (DraggedItem.ID >= ItemsData.Num() || DraggedItem.ID <= 0) // ID valid check
 	{
 		check(false);
@@ -380,7 +381,7 @@ void UMInventoryComponent::StoreDraggedToAnySlot(FItem& DraggedItem)
 
 	// We consider any slot as empty if its Quantity is 0, no matter what ID it has
 
-	for (auto& Slot : Slots)
+	for (auto& Slot : Slots.Items)
 	{
 		if (Slot.Item.ID >= ItemsData.Num())
 		{
@@ -394,7 +395,7 @@ void UMInventoryComponent::StoreDraggedToAnySlot(FItem& DraggedItem)
 			Slot.Item.Quantity += QuantityToAdd;
 			DraggedItem.Quantity -= QuantityToAdd;
 
-			Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+			OnSlotChanged(Slot);
 		}
 
 		if (DraggedItem.Quantity == 0)
@@ -405,7 +406,7 @@ void UMInventoryComponent::StoreDraggedToAnySlot(FItem& DraggedItem)
 
 	if (DraggedItem.Quantity > 0)
 	{
-		for (auto& Slot : Slots)
+		for (auto& Slot : Slots.Items)
 		{
 			// Search for empty slots
 			if (Slot.Item.Quantity == 0)
@@ -415,7 +416,7 @@ void UMInventoryComponent::StoreDraggedToAnySlot(FItem& DraggedItem)
 				Slot.Item.Quantity += QuantityToAdd;
 				DraggedItem.Quantity -= QuantityToAdd;
 
-				Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+				OnSlotChanged(Slot);
 			}
 
 			if (DraggedItem.Quantity == 0)
@@ -442,7 +443,7 @@ void UMInventoryComponent::StoreDraggedToSpecificSlot(int SlotNumberInArray, FIt
 
 
 	// Invalid slot number or invalid DraggedItem
-	if (Slots.Num() <= SlotNumberInArray || DraggedItem.Quantity <= 0 || DraggedItem.ID <= 0)
+	if (Slots.Items.Num() <= SlotNumberInArray || DraggedItem.Quantity <= 0 || DraggedItem.ID <= 0)
 	{
 		check(false);
 		StoreDraggedToAnySlot(DraggedItem);
@@ -450,7 +451,7 @@ void UMInventoryComponent::StoreDraggedToSpecificSlot(int SlotNumberInArray, FIt
 	}
 
 	// Slot is taken by an item with different ID
-	if (Slots[SlotNumberInArray].Item.Quantity > 0 && Slots[SlotNumberInArray].Item.ID != DraggedItem.ID)
+	if (Slots.Items[SlotNumberInArray].Item.Quantity > 0 && Slots.Items[SlotNumberInArray].Item.ID != DraggedItem.ID)
 	{
 		StoreDraggedToAnySlot(DraggedItem);
 		return;
@@ -464,7 +465,7 @@ void UMInventoryComponent::StoreDraggedToSpecificSlot(int SlotNumberInArray, FIt
 	}
 
 	// Couldn't find the item data
-	const auto ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
+	const auto& ItemsData = pMGameInstance->ItemsDataAsset->ItemsData;
 	if (DraggedItem.ID >= ItemsData.Num() || DraggedItem.ID <= 0) // ID valid check
 	{
 		check(false);
@@ -473,7 +474,7 @@ void UMInventoryComponent::StoreDraggedToSpecificSlot(int SlotNumberInArray, FIt
 
 	// Slot is valid to put the item in
 	const auto MaxStack = ItemsData[DraggedItem.ID].MaxStack;
-	const auto QuantityToStore = FMath::Min(DraggedItem.Quantity, MaxStack - Slots[SlotNumberInArray].Item.Quantity);
+	const auto QuantityToStore = FMath::Min(DraggedItem.Quantity, MaxStack - Slots.Items[SlotNumberInArray].Item.Quantity);
 	check(QuantityToStore >= 0);
 
 	if (QuantityToStore == 0) // Slot was already full or got 0 capacity
@@ -483,9 +484,9 @@ void UMInventoryComponent::StoreDraggedToSpecificSlot(int SlotNumberInArray, FIt
 	}
 	//-------------------------------
 
-	Slots[SlotNumberInArray].Item.ID = DraggedItem.ID;
-	Slots[SlotNumberInArray].Item.Quantity += QuantityToStore;
-	Slots[SlotNumberInArray].OnSlotChangedDelegate.Broadcast(Slots[SlotNumberInArray].Item.ID, Slots[SlotNumberInArray].Item.Quantity);
+	Slots.Items[SlotNumberInArray].Item.ID = DraggedItem.ID;
+	Slots.Items[SlotNumberInArray].Item.Quantity += QuantityToStore;
+	OnSlotChanged(Slots.Items[SlotNumberInArray]);
 
 	DraggedItem.Quantity -= QuantityToStore;
 
@@ -501,22 +502,22 @@ FItem UMInventoryComponent::DragItemFromSpecificSlot(int SlotNumberInArray, int
 {
 	//TODO: Should be replicated and do validation
 
-	if (Slots.Num() <= SlotNumberInArray || Quantity == 0)
+	if (Slots.Items.Num() <= SlotNumberInArray || Quantity == 0)
 	{
 		check(false);
 		return {};
 	}
 
-	const int QuantityToTake = FMath::Min(Quantity, Slots[SlotNumberInArray].Item.Quantity);
+	const int QuantityToTake = FMath::Min(Quantity, Slots.Items[SlotNumberInArray].Item.Quantity);
 
-	Slots[SlotNumberInArray].Item.Quantity -= QuantityToTake;
+	Slots.Items[SlotNumberInArray].Item.Quantity -= QuantityToTake;
 
-	Slots[SlotNumberInArray].OnSlotChangedDelegate.Broadcast(Slots[SlotNumberInArray].Item.ID, Slots[SlotNumberInArray].Item.Quantity);
+	OnSlotChanged(Slots.Items[SlotNumberInArray]);
 
 	OnAnySlotChangedDelegate.Broadcast();
 
 	check(QuantityToTake != 0);
-	return {Slots[SlotNumberInArray].Item.ID, QuantityToTake};
+	return {Slots.Items[SlotNumberInArray].Item.ID, QuantityToTake};
 }
 
 /*void UMInventoryComponent::Client_OnTakeItemFromSpecificSlot_Implementation(const FItem& ItemToStore)
@@ -527,7 +528,7 @@ FItem UMInventoryComponent::DragItemFromSpecificSlot(int SlotNumberInArray, int
 bool UMInventoryComponent::DoesContainEnough(FItem ItemToCheck)
 {
 	if (ItemToCheck.Quantity == 0) {check(false); return true;}
-	for (auto Slot : Slots)
+	for (auto Slot : Slots.Items)
 	{
 		if (Slot.Item.ID == ItemToCheck.ID)
 		{
@@ -549,19 +550,19 @@ bool UMInventoryComponent::IsEnoughSpace(FItem ItemToCheck, const UObject* World
 
 	if (const auto ItemsDataAsset = GetItemsDataAsset(WorldContextObject))
 	{
-		const auto ItemsData = ItemsDataAsset->ItemsData;
+		const auto& ItemsData = ItemsDataAsset->ItemsData;
 		if (ItemsData.Num() <= ItemToCheck.ID || ItemToCheck.ID <= 0) { check(false); return false; }
 		const auto MaxStack = ItemsData[ItemToCheck.ID].MaxStack;
-		for (int i = 0; i < Slots.Num(); ++i)
+		for (int i = 0; i < Slots.Items.Num(); ++i)
 		{
-			if (Slots[i].Item.Quantity == 0) // The slot is empty
+			if (Slots.Items[i].Item.Quantity == 0) // The slot is empty
 			{
 				ItemToCheck.Quantity -= MaxStack;
 			}
 			else
-			if (Slots[i].Item.ID == ItemToCheck.ID)
+			if (Slots.Items[i].Item.ID == ItemToCheck.ID)
 			{
-				ItemToCheck.Quantity -= FMath::Max(MaxStack - Slots[i].Item.Quantity, 0);
+				ItemToCheck.Quantity -= FMath::Max(MaxStack - Slots.Items[i].Item.Quantity, 0);
 			}
 
 			if (ItemToCheck.Quantity <= 0)
@@ -581,54 +582,87 @@ void UMInventoryComponent::RemoveItem(FItem ItemToRemove)
 		return;
 	}
 
-	for (int i = 0; i < Slots.Num(); ++i)
+	for (int i = 0; i < Slots.Items.Num(); ++i)
 	{
-		if (Slots[i].Item.ID == ItemToRemove.ID)
+		if (Slots.Items[i].Item.ID == ItemToRemove.ID)
 		{
-			const int QuantityToTake = FMath::Min(Slots[i].Item.Quantity, ItemToRemove.Quantity);
-			Slots[i].Item.Quantity -= QuantityToTake;
+			const int QuantityToTake = FMath::Min(Slots.Items[i].Item.Quantity, ItemToRemove.Quantity);
+			Slots.Items[i].Item.Quantity -= QuantityToTake;
 			ItemToRemove.Quantity -= QuantityToTake;
 
-			Slots[i].OnSlotChangedDelegate.Broadcast(Slots[i].Item.ID, Slots[i].Item.Quantity);
-			OnAnySlotChangedDelegate.Broadcast();
+			OnSlotChanged(Slots.Items[i]);
 
 			if (ItemToRemove.Quantity == 0)
 			{
-				return;
+				break;
 			}
 		}
 	}
+
+	OnAnySlotChangedDelegate.Broadcast();
 }
 
 void UMInventoryComponent::SwapItems(FItem& A, int SlotNumberInArray)
 {
-	if (SlotNumberInArray >= Slots.Num())
+	if (SlotNumberInArray >= Slots.Items.Num())
 		return;
 
-	Swap(A, Slots[SlotNumberInArray].Item);
+	Swap(A, Slots.Items[SlotNumberInArray].Item);
 
-	if (A.ID != Slots[SlotNumberInArray].Item.ID || A.Quantity != Slots[SlotNumberInArray].Item.Quantity) // At least any difference
+	if (A.ID != Slots.Items[SlotNumberInArray].Item.ID || A.Quantity != Slots.Items[SlotNumberInArray].Item.Quantity) // At least any difference
 	{
 		OnAnySlotChangedDelegate.Broadcast();
 	}
 
-	Slots[SlotNumberInArray].OnSlotChangedDelegate.Broadcast(Slots[SlotNumberInArray].Item.ID, Slots[SlotNumberInArray].Item.Quantity);
+	OnSlotChanged(Slots.Items[SlotNumberInArray]);
 }
 
 void UMInventoryComponent::Empty()
 {
 	// In current implementation we keep the inventory capacity but just remove all the items
-	for (int i = 0; i < Slots.Num(); ++i)
+	bool bChanged = false;
+	for (auto& Slot : Slots.Items)
+	{
+		if (Slot.Item.Quantity == 0)
+			continue;
+		Slot.Item = {0, 0};
+		OnSlotChanged(Slot);
+		bChanged = true;
+	}
+
+	if (bChanged)
+	{
+		OnAnySlotChangedDelegate.Broadcast();
+	}
+}
+
+void UMInventoryComponent::Sort()
+{
+	auto SortedItems = GetItemCopies(true);
+	SortItems(SortedItems, this);
+
+	bool bChanged = false;
+	for (int i = 0; i < Slots.Items.Num(); ++i)
+	{
+		auto& Slot = Slots.Items[i];
+		const FItem SortedItem = SortedItems.IsValidIndex(i) ? SortedItems[i] : FItem{0, 0};
+		// We consider any slot as empty if its Quantity is 0, no matter what ID it has
+		if (Slot.Item == SortedItem || (Slot.Item.Quantity == 0 && SortedItem.Quantity == 0))
+			continue;
+		Slot.Item = SortedItem;
+		OnSlotChanged(Slot);
+		bChanged = true;
+	}
+
+	if (bChanged)
 	{
-		Slots[i].Item = {0, 0};
-		Slots[i].OnSlotChangedDelegate.Broadcast(0, 0);
 		OnAnySlotChangedDelegate.Broadcast();
 	}
 }
 
 void UMInventoryComponent::SetFlagToAllSlots(FSlot::ESlotFlags Flag)
 {
-	for (auto& Slot : Slots)
+	for (auto& Slot : Slots.Items)
 	{
 		Slot.SetFlag(Flag);
 	}
@@ -641,8 +675,39 @@ void UMInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(UMInventoryComponent, Slots);
 }
 
-void UMInventoryComponent::OnRep_Slots()
+void UMInventoryComponent::OnSlotChanged(FSlot& Slot)
+{
+	Slots.MarkItemDirty(Slot);
+	Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+}
+
+void UMInventoryComponent::OnSlotReplicated(FSlot& Slot, bool bAddedOrRemoved)
 {
+	bReplicatedSlotChanged = true;
+	if (bAddedOrRemoved)
+	{
+		bReplicatedSlotsNumberChanged = true;
+		return;
+	}
+
+	Slot.OnSlotChangedDelegate.Broadcast(Slot.Item.ID, Slot.Item.Quantity);
+}
+
+void UMInventoryComponent::OnSlotsReplicated()
+{
+	if (!bReplicatedSlotChanged)
+		return;
+
+	const bool bRecreateWidgets = bReplicatedSlotsNumberChanged;
+	bReplicatedSlotChanged = false;
+	bReplicatedSlotsNumberChanged = false;
+
+	OnAnySlotChangedDelegate.Broadcast();
+
+	// Slot widgets are bound to their slots and update themselves, unless there are new slots without widgets
+	if (!bRecreateWidgets)
+		return;
+
 	// TODO: Use a delegate instead of direct accessing AMPlayerController
 	if (auto* MPlayerController = Cast<AMPlayerController>(UGameplayStatics::GetPlayerController(this, 0)))
 	{
@@ -665,3 +730,42 @@ void UMInventoryComponent::OnRep_Slots()
 		}
 	}
 }
+
+void UMInventoryComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	Slots.Owner = this;
+}
+
+void FSlot::PreReplicatedRemove(const FMSlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnSlotReplicated(*this, true);
+	}
+}
+
+void FSlot::PostReplicatedAdd(const FMSlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnSlotReplicated(*this, true);
+	}
+}
+
+void FSlot::PostReplicatedChange(const FMSlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnSlotReplicated(*this, false);
+	}
+}
+
+void FMSlotArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Owner)
+	{
+		Owner->OnSlotsReplicated();
+	}
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "MInventoryComponent.generated.h"
 
+class UMInventoryComponent;
+
 USTRUCT(BlueprintType)
 struct FItem
 {
@@ -24,17 +27,22 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSlotChanged, int, NewItemID, int
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTakeItemFromSpecificSlot, const FItem&, ItemToStore);
 DECLARE_MULTICAST_DELEGATE(FOnAnySlotChanged);
 
+/** Replicated one by one. Only the slots marked dirty are sent, see UMInventoryComponent::OnSlotChanged */
 USTRUCT(BlueprintType)
-struct FSlot
+struct FSlot : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
 	UPROPERTY()
 	FItem Item;
 
-	/** Server only */
+	/** Broadcast on the server when the slot is changed and on clients when the change is received */
 	FOnSlotChanged OnSlotChangedDelegate;
 
+	void PreReplicatedRemove(const struct FMSlotArray& InArraySerializer);
+	void PostReplicatedAdd(const struct FMSlotArray& InArraySerializer);
+	void PostReplicatedChange(const struct FMSlotArray& InArraySerializer);
+
 	enum class ESlotFlags : uint8 {
 		None = 0x00,
 		Locked = 0x01,
@@ -58,6 +66,36 @@ private:
 	ESlotFlags Flags = ESlotFlags::None;
 };
 
+/** Inventory slots replicated as a delta: moving one item sends one slot instead of the whole array */
+USTRUCT()
+struct FMSlotArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FSlot> Items;
+
+	/** Gets the per-slot callbacks on clients. Set in UMInventoryComponent::PostInitProperties */
+	UPROPERTY(NotReplicated)
+	UMInventoryComponent* Owner = nullptr;
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FSlot, FMSlotArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FMSlotArray> : public TStructOpsTypeTraitsBase2<FMSlotArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 
 //TODO: Add additional checks for IsLocked in c++ functions. Now there are only some in the slot widget blueprint
 /** A character's inventory component. Store items, support put-in, get-out and sort logic */
@@ -80,9 +118,8 @@ public:
 	TArray<FItem> MaxPriceCombination(int M);
 	//TArray<FItem> GetMaximumItemsForPrice(int Price);
 
-	TArray<FSlot>& GetSlots() { return Slots; }
-
-	const TArray<FSlot>& GetSlotsConst() const { return Slots; }
+	/** Read only, so clients never miss a change. Slots are changed by the functions below, they all go through OnSlotChanged */
+	const TArray<FSlot>& GetSlots() const { return Slots.Items; }
 
 	static void SortSlots(TArray<FSlot>& IN_Slots, const UObject* WorldContextObject);
 
@@ -124,19 +161,42 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SwapItems(UPARAM(ref)FItem& A, int SlotNumberInArray);
 
+	/** Remove all the items keeping the capacity. Only the slots that weren't empty are sent and notified */
 	void Empty();
 
+	/** Server only. Put the items in order, empty slots go last. Only the slots that got a different item are sent and notified */
+	UFUNCTION(BlueprintCallable)
+	void Sort();
+
 	void SetFlagToAllSlots(FSlot::ESlotFlags Flag);
 
+	/** Broadcast once per operation on the server and once per received update on clients, no matter how many slots changed */
 	FOnAnySlotChanged OnAnySlotChangedDelegate;
 
+	/** Listeners can be bound even to a read only inventory, binding doesn't change the slot */
+	FOnSlotChanged& GetSlotChangedDelegate(int SlotNumberInArray) const { return const_cast<FSlot&>(Slots.Items[SlotNumberInArray]).OnSlotChangedDelegate; }
+
+	/** Marks the slot to be replicated and notifies its listeners */
+	void OnSlotChanged(FSlot& Slot);
+
+	/** Client side, called by FMSlotArray for every slot received */
+	void OnSlotReplicated(FSlot& Slot, bool bAddedOrRemoved);
+
+	/** Client side, called by FMSlotArray once all the slots of an update are received */
+	void OnSlotsReplicated();
+
 protected:
 
+	virtual void PostInitProperties() override;
+
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	UFUNCTION()
-	void OnRep_Slots();
+	UPROPERTY(Replicated)
+	FMSlotArray Slots;
+
+	/** Slots were added or removed in the update being received, so the widgets showing them have to be re-created */
+	bool bReplicatedSlotsNumberChanged = false;
 
-	UPROPERTY(ReplicatedUsing=OnRep_Slots)
-	TArray<FSlot> Slots;
+	/** Any slot was received in the update being received */
+	bool bReplicatedSlotChanged = false;
 };
\ No newline at end of file
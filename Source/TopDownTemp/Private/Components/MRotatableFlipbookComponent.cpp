@@ -13,88 +13,175 @@ UMRotatableFlipbookComponent::UMRotatableFlipbookComponent(const FObjectInitiali
 {
 }
 
-void UMRotatableFlipbookComponent::SetFlipbookByRotation(float ViewingAngle)
+FFlipbookSectorTable::FFlipbookSectorTable(int32 FlipbooksCount)
 {
-	if (const auto FlipbookArray = FlipbookByAction.Find(Action))
+	// Segment values are integers on purpose, the sectors must match the ones the flipbooks were authored for
+	if (FlipbooksCount <= 0)
 	{
-		const auto FlipbooksCount = FlipbookArray->Flipbooks.Num();
-		if (FlipbooksCount == 0)
-		{
-			SetFlipbook(nullptr);
-			OnFlipbookChangedDelegate.Broadcast(nullptr, 0.f, 0.f, false, false, {});
-			return;
-		}
-
-		const auto sign = ViewingAngle >= 0.f ? 1.f : -1.f;
-		// The angle of object's gaze. 0 means match with camera vector,
-		// 90 = watches to the right, 180 or -180 = face the camera, -90 = watches to the left
-		const auto AbsViewingAngle = abs(ViewingAngle);
-
-		// Determine to which sector of the coordinate circle ViewingAngle belongs
-		int FlipbookIndex;
-		if (FlipbooksCount <= 2)
+		return;
+	}
+	if (FlipbooksCount <= 2)
+	{
+		const int AngleSegmentValue = 180.f / FlipbooksCount;
+		for (int32 i = 0; i < FlipbooksCount; ++i)
 		{
-			const int AngleSegmentValue = 180.f / FlipbooksCount;
-			FlipbookIndex = StaticCast<int>(AbsViewingAngle / AngleSegmentValue);
+			UpperBounds.Add((i + 1) * AngleSegmentValue);
 		}
-		else
+	}
+	else
+	{
+		// Sectors are centered around the multiples of the segment, so the first and the last ones are halves
+		const int AngleSegmentValue = 180.f / (FlipbooksCount - 1);
+		for (int32 i = 0; i < FlipbooksCount; ++i)
 		{
-			const int AngleSegmentValue = 180.f / (FlipbooksCount - 1);
-			FlipbookIndex = StaticCast<int>((AbsViewingAngle + AngleSegmentValue / 2) / AngleSegmentValue);
+			UpperBounds.Add((i + 1) * AngleSegmentValue - AngleSegmentValue / 2);
 		}
+	}
+}
 
-		if (FlipbookIndex >= FlipbooksCount)
-		{
-			SetFlipbook(nullptr);
-			OnFlipbookChangedDelegate.Broadcast(nullptr, 0.f, 0.f, false, false, {});
-			return;
-		}
+int32 FFlipbookSectorTable::GetFlipbookIndex(float AbsViewingAngle) const
+{
+	int32 FlipbookIndex = 0;
+	while (FlipbookIndex < UpperBounds.Num() && AbsViewingAngle >= UpperBounds[FlipbookIndex])
+	{
+		++FlipbookIndex;
+	}
+	return FlipbookIndex;
+}
 
-		// Mirror the flipbook if needed
-		FVector Scale = GetRelativeScale3D();
-		if (sign == -1.f && FlipbookIndex != 0 && FlipbookIndex != FlipbooksCount - 1)
-		{
-			Scale.X = abs(Scale.X);
-		}
-		else
-		{
-			Scale.X = -abs(Scale.X);
-		}
+void UMRotatableFlipbookComponent::SetFlipbookByRotation(float ViewingAngle)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMRotatableFlipbookComponent::SetFlipbookByRotation);
 
-		if (FlipbookArray->Flipbooks[FlipbookIndex] != LastValidFlipbook ||
-			PlayRate != LastValidPlayRate ||
-			bLooping != LastValidbLoopping ||
-			//bReversePlayback != LastValidbReversePlayback ||
-			Scale != GetRelativeScale3D() ||
-			!SourceFlipbook
-			)
-		{
-			const auto PlaybackPosition = GetPlaybackPosition();
-			SetFlipbook(FlipbookArray->Flipbooks[FlipbookIndex]);
-			SetPlaybackPosition(PlaybackPosition, false);
-			SetPlayRate(FlipbookArray->PlayRate);
-			SetLooping(FlipbookArray->bLooping);
-			SetRelativeScale3D(Scale);
-			Play();
-
-			LastValidFlipbook = FlipbookArray->Flipbooks[FlipbookIndex];
-			LastValidPlayRate = GetPlayRate();
-			LastValidbLoopping = bLooping;
-			LastValidbReversePlayback = bReversePlayback;
-			LastValidScale = Scale;
-
-			LastValidViewingAngle = ViewingAngle;
-
-			OnFlipbookChangedDelegate.Broadcast(GetFlipbook(), PlaybackPosition, PlayRate, bLooping, bReversePlayback, Scale);
-		}
+	LastValidViewingAngle = ViewingAngle;
+
+	if (!bActionCacheValid || CachedAction != Action)
+	{
+		RefreshActionCache();
+	}
+
+	if (!CachedFlipbookArray)
+	{
+		ClearFlipbook();
+		return;
+	}
+
+	const auto FlipbooksCount = CachedFlipbookArray->Flipbooks.Num();
+	// The angle of object's gaze. 0 means match with camera vector,
+	// 90 = watches to the right, 180 or -180 = face the camera, -90 = watches to the left
+	const int32 FlipbookIndex = CachedSectorTable->GetFlipbookIndex(abs(ViewingAngle));
+	if (FlipbookIndex >= FlipbooksCount)
+	{
+		ClearFlipbook();
+		return;
+	}
+
+	// Side views are mirrored when the object watches to the left
+	const bool bMirrored = ViewingAngle < 0.f && FlipbookIndex != 0 && FlipbookIndex != FlipbooksCount - 1;
+
+	// Still the same sector, nothing to change unless the playback settings were altered from outside
+	if (FlipbookIndex == LastFlipbookIndex && bMirrored == bLastMirrored && SourceFlipbook &&
+		PlayRate == LastValidPlayRate && bLooping == LastValidbLoopping && GetRelativeScale3D() == LastValidScale)
+	{
+		return;
+	}
+	LastFlipbookIndex = FlipbookIndex;
+	bLastMirrored = bMirrored;
+
+	FVector Scale = GetRelativeScale3D();
+	Scale.X = bMirrored ? abs(Scale.X) : -abs(Scale.X);
+
+	if (CachedFlipbookArray->Flipbooks[FlipbookIndex] != LastValidFlipbook ||
+		PlayRate != LastValidPlayRate ||
+		bLooping != LastValidbLoopping ||
+		//bReversePlayback != LastValidbReversePlayback ||
+		Scale != GetRelativeScale3D() ||
+		!SourceFlipbook
+		)
+	{
+		const auto PlaybackPosition = GetPlaybackPosition();
+		SetFlipbook(CachedFlipbookArray->Flipbooks[FlipbookIndex]);
+		SetPlaybackPosition(PlaybackPosition, false);
+		SetPlayRate(CachedFlipbookArray->PlayRate);
+		SetLooping(CachedFlipbookArray->bLooping);
+		SetRelativeScale3D(Scale);
+		Play();
+
+		LastValidFlipbook = CachedFlipbookArray->Flipbooks[FlipbookIndex];
+		LastValidPlayRate = GetPlayRate();
+		LastValidbLoopping = bLooping;
+		LastValidbReversePlayback = bReversePlayback;
+		LastValidScale = Scale;
+
+		++FlipbookChangesNumber;
+		OnFlipbookChangedDelegate.Broadcast(GetFlipbook(), PlaybackPosition, PlayRate, bLooping, bReversePlayback, Scale);
+	}
+}
+
+void UMRotatableFlipbookComponent::RefreshActionCache()
+{
+	CachedAction = Action;
+	bActionCacheValid = true;
+	LastFlipbookIndex = INDEX_NONE; // Force the selection, the sectors might differ
+
+	CachedFlipbookArray = FlipbookByAction.Find(Action);
+	if (!CachedFlipbookArray)
+	{
+		CachedSectorTable = nullptr;
+		return;
+	}
+
+	if (const auto SectorTable = SectorTables.Find(Action))
+	{
+		CachedSectorTable = SectorTable;
 	}
 	else
 	{
-		SetFlipbook(nullptr);
-		OnFlipbookChangedDelegate.Broadcast(nullptr, 0.f, 0.f, false, false, {});
+		CachedSectorTable = &SectorTables.Add(Action, FFlipbookSectorTable(CachedFlipbookArray->Flipbooks.Num()));
+	}
+}
+
+void UMRotatableFlipbookComponent::ClearFlipbook()
+{
+	LastFlipbookIndex = INDEX_NONE;
+
+	if (!SourceFlipbook && !LastValidFlipbook)
+	{
+		return; // Already cleared, listeners know it
 	}
+
+	SetFlipbook(nullptr);
+	LastValidFlipbook = nullptr;
+
+	++FlipbookChangesNumber;
+	OnFlipbookChangedDelegate.Broadcast(nullptr, 0.f, 0.f, false, false, {});
+}
+
+void UMRotatableFlipbookComponent::SetActionFlipbooks(FName InAction, const FFlipbooksArray& Flipbooks)
+{
+	FlipbookByAction.Add(InAction, Flipbooks);
+	InvalidateActionCache();
+	SetFlipbookByRotation(LastValidViewingAngle);
 }
 
+void UMRotatableFlipbookComponent::InvalidateActionCache()
+{
+	// The cached pointers point into FlipbookByAction
+	bActionCacheValid = false;
+	CachedFlipbookArray = nullptr;
+	CachedSectorTable = nullptr;
+	SectorTables.Empty();
+}
+
+#if WITH_EDITOR
+void UMRotatableFlipbookComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	InvalidateActionCache();
+}
+#endif
+
 void UMRotatableFlipbookComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	FActorComponentTickFunction* ThisTickFunction)
 {
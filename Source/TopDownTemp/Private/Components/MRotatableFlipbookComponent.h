@@ -34,6 +34,20 @@ public:
 	uint32 bLooping:1;
 };
 
+/** Viewing angle sectors of one action, precomputed from the number of its flipbooks */
+struct FFlipbookSectorTable
+{
+	FFlipbookSectorTable() = default;
+
+	explicit FFlipbookSectorTable(int32 FlipbooksCount);
+
+	/** Returns the flipbook index for the absolute viewing angle, or the number of flipbooks if it's out of all the sectors */
+	int32 GetFlipbookIndex(float AbsViewingAngle) const;
+
+	/** Exclusive upper bound of the absolute viewing angle for each flipbook index */
+	TArray<float, TInlineAllocator<8>> UpperBounds;
+};
+
 //TODO: Add a minimum playing time for every flipbook to avoid flickering due to frequent animation changes
 /** Component that uses an array of flipbooks to mimic multi-directional actions for a flat body/part.
  *  Not replicated. Actor blueprint needs to store action names in RepNotify FName variables and put them to SetAction() when needed. */
@@ -51,11 +65,18 @@ public:
 	void SetAction(FName _Action) { Action = _Action; SetFlipbookByRotation(LastValidViewingAngle); }
 
 	/** 
-	 * Called to set appropriate flipbook to represent the angular direction. 
+	 * Called to set appropriate flipbook to represent the angular direction.
+	 * Does nothing unless the angle crossed a sector boundary or the action changed, so it's cheap to call every frame.
 	 * @param ViewingAngle is angle between Camera->Actor and ActorsGaze vectors. 0 if actor's gaze matches the camera's
 	 */
 	void SetFlipbookByRotation(float ViewingAngle);
 
+	/** Replaces or adds the flipbooks of the action at runtime. The current flipbook is selected again */
+	void SetActionFlipbooks(FName InAction, const FFlipbooksArray& Flipbooks);
+
+	/** For debugging. How many times the flipbook actually changed and listeners were notified */
+	int32 GetFlipbookChangesNumber() const { return FlipbookChangesNumber; }
+
 	UPROPERTY(BlueprintAssignable, Category = "MRotatableFlipbookComponent")
 	FOnSpriteChanged OnSpriteChangeDelegate;
 
@@ -65,6 +86,19 @@ private:
 
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** Finds the flipbooks and the sector table of the current action, so it's done once per action change */
+	void RefreshActionCache();
+
+	/** Must be called whenever FlipbookByAction changes */
+	void InvalidateActionCache();
+
+	/** Sets no flipbook. Listeners are notified only if there was one */
+	void ClearFlipbook();
+
 	/** The action currently being played */
 	FName Action = FName("Idle");
 
@@ -78,4 +112,19 @@ private:
 	bool LastValidbReversePlayback;
 	FVector LastValidScale;
 	float LastValidViewingAngle;
+
+	/** Built lazily, once per action */
+	TMap<FName, FFlipbookSectorTable> SectorTables;
+
+	/** The action the cached pointers below were found for */
+	FName CachedAction = NAME_None;
+	const FFlipbooksArray* CachedFlipbookArray = nullptr;
+	const FFlipbookSectorTable* CachedSectorTable = nullptr;
+	bool bActionCacheValid = false;
+
+	/** Sector the current flipbook was selected for. INDEX_NONE if there is no flipbook */
+	int32 LastFlipbookIndex = INDEX_NONE;
+	bool bLastMirrored = false;
+
+	int32 FlipbookChangesNumber = 0;
 };
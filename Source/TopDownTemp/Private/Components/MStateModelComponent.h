@@ -6,12 +6,44 @@
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnStateDirty);
 
+/** All the state flags. A flag added here gets its bit, its replication and its place in FStateModelCopy::Is<Name>.\n
+ * The copy field and the blueprint accessors still have to be declared, the compiler fails until they are. */
+#define M_STATE_MODEL_FLAGS(Flag) \
+	Flag(Communicating) \
+	Flag(Dashing) \
+	Flag(Dying) \
+	Flag(Fighting) \
+	Flag(Moving) \
+	Flag(Picking) \
+	Flag(Reversing) \
+	Flag(Sprinting) \
+	Flag(TakingDamage) \
+	Flag(TurningLeft) \
+	Flag(TurningRight)
+
+enum class EMStateFlag : uint8
+{
+#define M_STATE_FLAG_ENUM(Name) Name,
+	M_STATE_MODEL_FLAGS(M_STATE_FLAG_ENUM)
+#undef M_STATE_FLAG_ENUM
+	Num
+};
+
+/** Bits are indexed by EMStateFlag */
+using FMStateFlags = uint16;
+
+static_assert(static_cast<int32>(EMStateFlag::Num) <= sizeof(FMStateFlags) * 8, "State flags don't fit FMStateFlags anymore, widen it");
+
+#define M_STATE_FLAG_COUNT(Name) + 1
+static_assert(static_cast<int32>(EMStateFlag::Num) == 0 M_STATE_MODEL_FLAGS(M_STATE_FLAG_COUNT), "EMStateFlag and M_STATE_MODEL_FLAGS are out of sync");
+#undef M_STATE_FLAG_COUNT
+
 /** A copy of all state data used by animation graphs or other thread-safe entities. */
 USTRUCT(BlueprintType)
 struct FStateModelCopy
 {
 	GENERATED_BODY()
-	// When adding new fields, don't forget to add it here
+	// One field per flag of M_STATE_MODEL_FLAGS, filled in by UMStateModelComponent::GetCopy()
 	UPROPERTY(BlueprintReadOnly)
 	bool IsDirty = true;
 	UPROPERTY(BlueprintReadOnly)
@@ -38,6 +70,11 @@ struct FStateModelCopy
 	bool IsTurningRight = false;
 };
 
+// Unlike the size of the struct, doesn't depend on the padding nor on the fields that aren't flags
+#define M_STATE_FLAG_COPY_FIELD(Name) static_assert(std::is_same_v<decltype(FStateModelCopy::Is##Name), bool>, "FStateModelCopy misses Is" #Name);
+M_STATE_MODEL_FLAGS(M_STATE_FLAG_COPY_FIELD)
+#undef M_STATE_FLAG_COPY_FIELD
+
 /** Component that stores and replicates all boolean states e.g. IsDashing, IsTakingDamage, IsDying, etc.\n
  * Supposed to be attached to AMCharacter or AMActor */
 // TODO: Supposedly will be using GAS attributes instead
@@ -50,61 +87,79 @@ public:
 	bool GetIsDirty() const { return IsDirty; }
 	void CleanDirty() { IsDirty = false; }
 
-	// When adding new fields, don't forget add it here
+	bool HasFlag(EMStateFlag Flag) const { return (StateFlags & GetFlagMask(Flag)) != 0; }
+
+	/** Marks the model dirty if the value changed */
+	inline void SetFlag(EMStateFlag Flag, bool Value);
+
+	FMStateFlags GetStateFlags() const { return StateFlags; }
+
+	// Blueprint accessors, one pair per flag of M_STATE_MODEL_FLAGS
+	UFUNCTION(BlueprintCallable)
+	bool GetIsCommunicating() const { return HasFlag(EMStateFlag::Communicating); }
+
+	UFUNCTION(BlueprintCallable)
+	void SetIsCommunicating(bool IN_IsCommunicating) { SetFlag(EMStateFlag::Communicating, IN_IsCommunicating); }
+
+	UFUNCTION(BlueprintCallable)
+	bool GetIsDashing() const { return HasFlag(EMStateFlag::Dashing); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsCommunicating() const { return IsCommunicating; }
-	
+	void SetIsDashing(bool IN_IsDashing) { SetFlag(EMStateFlag::Dashing, IN_IsDashing); }
+
 	UFUNCTION(BlueprintCallable)
-	bool GetIsDashing() const { return IsDashing; }
+	bool GetIsDying() const { return HasFlag(EMStateFlag::Dying); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsFighting() const { return IsFighting; }
+	void SetIsDying(bool IN_IsDying) { SetFlag(EMStateFlag::Dying, IN_IsDying); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsMoving() const { return IsMoving; }
+	bool GetIsFighting() const { return HasFlag(EMStateFlag::Fighting); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsReversing() const { return IsReversing; }
+	void SetIsFighting(bool IN_IsFighting) { SetFlag(EMStateFlag::Fighting, IN_IsFighting); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsSprinting() const { return IsSprinting; }
+	bool GetIsMoving() const { return HasFlag(EMStateFlag::Moving); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsTakingDamage() const { return IsTakingDamage; }
+	void SetIsMoving(bool IN_IsMoving) { SetFlag(EMStateFlag::Moving, IN_IsMoving); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsTurningLeft() const { return IsTurningLeft; }
+	bool GetIsPicking() const { return HasFlag(EMStateFlag::Picking); }
 
 	UFUNCTION(BlueprintCallable)
-	bool GetIsTurningRight() const { return IsTurningRight; }
+	void SetIsPicking(bool IN_IsPicking) { SetFlag(EMStateFlag::Picking, IN_IsPicking); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsCommunicating(bool IN_IsCommunicating);
+	bool GetIsReversing() const { return HasFlag(EMStateFlag::Reversing); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsDashing(bool IN_IsDashing);
+	void SetIsReversing(bool IN_IsReversing) { SetFlag(EMStateFlag::Reversing, IN_IsReversing); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsFighting(bool IN_IsFighting);
+	bool GetIsSprinting() const { return HasFlag(EMStateFlag::Sprinting); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsMoving(bool IN_IsMoving);
+	void SetIsSprinting(bool IN_IsSprinting) { SetFlag(EMStateFlag::Sprinting, IN_IsSprinting); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsReversing(bool IN_IsReversing);
+	bool GetIsTakingDamage() const { return HasFlag(EMStateFlag::TakingDamage); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsSprinting(bool IN_IsSprinting);
+	void SetIsTakingDamage(bool IN_IsTakingDamage) { SetFlag(EMStateFlag::TakingDamage, IN_IsTakingDamage); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsTakingDamage(bool IN_IsTakingDamage);
+	bool GetIsTurningLeft() const { return HasFlag(EMStateFlag::TurningLeft); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsTurningLeft(bool IN_IsTurningLeft);
+	void SetIsTurningLeft(bool IN_IsTurningLeft) { SetFlag(EMStateFlag::TurningLeft, IN_IsTurningLeft); }
 
 	UFUNCTION(BlueprintCallable)
-	inline void SetIsTurningRight(bool IN_IsTurningRight);
+	bool GetIsTurningRight() const { return HasFlag(EMStateFlag::TurningRight); }
+
+	UFUNCTION(BlueprintCallable)
+	void SetIsTurningRight(bool IN_IsTurningRight) { SetFlag(EMStateFlag::TurningRight, IN_IsTurningRight); }
 
 	UPROPERTY()
 	FOnStateDirty OnDirtyDelegate;
@@ -113,53 +168,24 @@ public:
 	FStateModelCopy GetCopy();
 
 protected:
-	// TODO: Figure out why making all properties using OnRep fixes the bug with inconsistent updates for client
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty)
+	static constexpr FMStateFlags GetFlagMask(EMStateFlag Flag) { return static_cast<FMStateFlags>(1u << static_cast<uint8>(Flag)); }
+
+	/** Set on the server when any flag changes, cleaned by the owner after it reacted */
 	bool IsDirty = true;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsCommunicating = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsDashing = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsDying = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsFighting = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsMoving = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsPicking = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsReversing = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsSprinting = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsTakingDamage = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsTurningLeft = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsDirty, VisibleAnywhere)
-	bool IsTurningRight = false;
+
+	/** All the flags replicated at once, so the client never sees a half-applied state. UHT needs the plain type, it's FMStateFlags */
+	UPROPERTY(ReplicatedUsing=OnRep_StateFlags, VisibleAnywhere)
+	uint16 StateFlags = 0;
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override
 	{
 		Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-		// When adding new fields, don't forget add it here
-		DOREPLIFETIME(UMStateModelComponent, IsDirty);
-		DOREPLIFETIME(UMStateModelComponent, IsCommunicating);
-		DOREPLIFETIME(UMStateModelComponent, IsDashing);
-		DOREPLIFETIME(UMStateModelComponent, IsDying);
-		DOREPLIFETIME(UMStateModelComponent, IsFighting);
-		DOREPLIFETIME(UMStateModelComponent, IsMoving);
-		DOREPLIFETIME(UMStateModelComponent, IsPicking);
-		DOREPLIFETIME(UMStateModelComponent, IsReversing);
-		DOREPLIFETIME(UMStateModelComponent, IsSprinting);
-		DOREPLIFETIME(UMStateModelComponent, IsTakingDamage);
-		DOREPLIFETIME(UMStateModelComponent, IsTurningLeft);
-		DOREPLIFETIME(UMStateModelComponent, IsTurningRight);
+		DOREPLIFETIME(UMStateModelComponent, StateFlags);
 	}
 
 	UFUNCTION()
-	void OnRep_IsDirty()
+	void OnRep_StateFlags()
 	{
 		OnDirtyDelegate.Broadcast();
 	}
@@ -2,83 +2,11 @@
 
 #include "MStateModelComponent.h"
 
-inline void UMStateModelComponent::SetIsCommunicating(bool IN_IsCommunicating)
+inline void UMStateModelComponent::SetFlag(EMStateFlag Flag, bool Value)
 {
-	if (IsCommunicating != IN_IsCommunicating)
+	if (HasFlag(Flag) != Value)
 	{
-		IsCommunicating = IN_IsCommunicating;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsDashing(bool IN_IsDashing)
-{
-	if (IsDashing != IN_IsDashing)
-	{
-		IsDashing = IN_IsDashing;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsFighting(bool IN_IsFighting)
-{
-	if (IsFighting != IN_IsFighting)
-	{
-		IsFighting = IN_IsFighting;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsMoving(bool IN_IsMoving)
-{
-	if (IsMoving != IN_IsMoving)
-	{
-		IsMoving = IN_IsMoving;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsReversing(bool IN_IsReversing)
-{
-	if (IsReversing != IN_IsReversing)
-	{
-		IsReversing = IN_IsReversing;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsSprinting(bool IN_IsSprinting)
-{
-	if (IsSprinting != IN_IsSprinting)
-	{
-		IsSprinting = IN_IsSprinting;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsTakingDamage(bool IN_IsTakingDamage)
-{
-	if (IsTakingDamage != IN_IsTakingDamage)
-	{
-		IsTakingDamage = IN_IsTakingDamage;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsTurningLeft(bool IN_IsTurningLeft)
-{
-	if (IsTurningLeft != IN_IsTurningLeft)
-	{
-		IsTurningLeft = IN_IsTurningLeft;
-		IsDirty = true;
-	}
-}
-
-inline void UMStateModelComponent::SetIsTurningRight(bool IN_IsTurningRight)
-{
-	if (IsTurningRight != IN_IsTurningRight)
-	{
-		IsTurningRight = IN_IsTurningRight;
+		StateFlags ^= GetFlagMask(Flag);
 		IsDirty = true;
 	}
 }
@@ -87,17 +15,11 @@ inline FStateModelCopy UMStateModelComponent::GetCopy()
 {
 	FStateModelCopy Result;
 
-	Result.IsCommunicating = IsCommunicating;
-	Result.IsDashing = IsDashing;
-	Result.IsDying = IsDying;
-	Result.IsFighting = IsFighting;
-	Result.IsMoving = IsMoving;
-	Result.IsPicking = IsPicking;
-	Result.IsReversing = IsReversing;
-	Result.IsSprinting = IsSprinting;
-	Result.IsTakingDamage = IsTakingDamage;
-	Result.IsTurningLeft = IsTurningLeft;
-	Result.IsTurningRight = IsTurningRight;
+	// The copy is always dirty, whoever consumes it must treat it as a fresh state
+	Result.IsDirty = true;
+#define M_STATE_FLAG_COPY(Name) Result.Is##Name = HasFlag(EMStateFlag::Name);
+	M_STATE_MODEL_FLAGS(M_STATE_FLAG_COPY)
+#undef M_STATE_FLAG_COPY
 
 	return Result;
 }
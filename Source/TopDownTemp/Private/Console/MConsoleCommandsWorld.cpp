@@ -1,7 +1,38 @@
 #include "MConsoleCommandsWorld.h"
 
+#include "Characters/MCharacter.h"
+#include "Components/MAttackPuddleComponent.h"
+#include "Components/MInventoryComponent.h"
+#include "Components/MRotatableFlipbookComponent.h"
+#include "Components/MStateModelComponent.h"
+#include "Components/MStatsModelComponent.h"
+#include "Controllers/MInventoryControllerComponent.h"
+#include "Controllers/MNPCController.h"
+#include "Controllers/MPlayerController.h"
 #include "Framework/MGameMode.h"
+#include "Helpers/MMeleeHitQuery.h"
+#include "TopDownTemp.h"
+#include "Managers/MColorTransitionSubsystem.h"
+#include "Managers/MCommunicationManager.h"
+#include "Managers/MGridAddressing.h"
+#include "Managers/MMetadataManager.h"
+#include "Managers/MNavPointPoolSubsystem.h"
+#include "Managers/MPathRequestSubsystem.h"
+#include "Managers/MPerceptionSubsystem.h"
+#include "Managers/MShadowSubsystem.h"
+#include "Managers/MSquadSubsystem.h"
+#include "Managers/MVirtualSimulationSubsystem.h"
 #include "Managers/MWorldGenerator.h"
+#include "Managers/RoadManager/MRoadManager.h"
+#include "StationaryActors/MActor.h"
+#include "StationaryActors/MGroundBlock.h"
+#include "StationaryActors/Outposts/MOutpostHouse.h"
+#include "StationaryActors/Outposts/OutpostGenerators/MOutpostGenerator.h"
+#include "UI/MInventorySlotWidget.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "Engine/NetDriver.h"
+#include "NavigationSystem.h"
 #include "Kismet/GameplayStatics.h"
 
 static TAutoConsoleVariable<FString> CVarToSpawnNightmare(
@@ -67,8 +98,1085 @@ void UMConsoleCommandsWorld::SpawnMob(const FString& MobClassString, int Quantit
 			if (!pPlayer)
 				return;
 
-			WorldGenerator->SpawnActorInRadius<AActor>(Class, pPlayer->GetActorLocation(), FRotator::ZeroRotator, {}, 150.f, 350.f);
+			// The area grows with the crowd, so hundreds of mobs still fit
+			const float MaxRadius = 350.f * FMath::Sqrt(static_cast<float>(FMath::Max(Quantity, 1)));
+			for (int i = 0; i < Quantity; ++i)
+			{
+				WorldGenerator->SpawnActorInRadius<AActor>(Class, pPlayer->GetActorLocation(), FRotator::ZeroRotator, {}, 150.f, MaxRadius);
+			}
 		}
 	}
 }
 
+
+void UMConsoleCommandsWorld::BenchmarkVillageLayouts(int Quantity)
+{
+#if !UE_BUILD_SHIPPING
+	const auto RoadManager = AMGameMode::GetRoadManager(this);
+	if (!RoadManager)
+		return;
+
+	const auto VillageClass = RoadManager->GetOutpostBPClasses().Find("Village");
+	if (!VillageClass || !VillageClass->Get())
+		return;
+
+	const auto VillageGenerator = VillageClass->Get()->GetDefaultObject<AMOutpostGenerator>();
+	if (!VillageGenerator)
+		return;
+
+	FOutpostLayoutRequest Request;
+	TArray<UMElementDataForGeneration*> ElementsData;
+	VillageGenerator->GetLayoutCircles(FVector::ZeroVector, Request.Circles, ElementsData, this);
+
+	int PlacementsNumber = 0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < Quantity; ++i)
+	{
+		Request.Seed = i;
+		PlacementsNumber += AMOutpostGenerator::ComputeLayout(Request).Num();
+	}
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogOutpostGenerator, Display, TEXT("Computed %d village layouts (%d elements) in %.2f ms, %.3f ms per layout"),
+		Quantity, PlacementsNumber, ElapsedMs, Quantity > 0 ? ElapsedMs / Quantity : 0.0);
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintResidentsStats()
+{
+#if !UE_BUILD_SHIPPING
+	int HousesNumber = 0;
+	int MaterializedNumber = 0;
+	int VirtualNumber = 0;
+	for (TActorIterator<AMOutpostHouse> It(GetWorld()); It; ++It)
+	{
+		++HousesNumber;
+		MaterializedNumber += It->GetMaterializedResidentsNumber();
+		VirtualNumber += It->GetVirtualResidentsNumber();
+	}
+
+	UE_LOG(LogOutpostGenerator, Display, TEXT("Houses: %d, materialized residents: %d, virtual residents: %d"),
+		HousesNumber, MaterializedNumber, VirtualNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkGridAddressing(int Quantity)
+{
+#if !UE_BUILD_SHIPPING
+	if (Quantity <= 0)
+		return;
+
+	// Square area of blocks centered at the origin, so negative indices are covered too
+	const int Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Quantity)));
+	TArray<FIntPoint> Blocks;
+	Blocks.Reserve(Side * Side);
+	for (int X = -Side / 2; X < Side - Side / 2; ++X)
+	{
+		for (int Y = -Side / 2; Y < Side - Side / 2; ++Y)
+		{
+			Blocks.Add({X, Y});
+		}
+	}
+
+	// Result is accumulated and logged so the compiler can't throw the loops away
+	int64 Checksum = 0;
+	const auto Measure = [&Checksum](const TCHAR* Name, const TFunctionRef<int64()>& Body)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Checksum += Body();
+		UE_LOG(LogTopDownTemp, Display, TEXT("%s: %.3f ms"), Name, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	};
+
+	const FIntPoint ChunkSize(4, 4);
+	Measure(TEXT("Float floor division"), [&Blocks, &ChunkSize]
+	{
+		int64 Sum = 0;
+		for (const auto& Block : Blocks)
+		{
+			Sum += FMath::FloorToInt(static_cast<float>(Block.X) / ChunkSize.X) + FMath::FloorToInt(static_cast<float>(Block.Y) / ChunkSize.Y);
+		}
+		return Sum;
+	});
+	Measure(TEXT("Integer floor division"), [&Blocks, &ChunkSize]
+	{
+		int64 Sum = 0;
+		for (const auto& Block : Blocks)
+		{
+			const auto Chunk = MGridAddressing::GetParentIndex(Block, ChunkSize);
+			Sum += Chunk.X + Chunk.Y;
+		}
+		return Sum;
+	});
+
+	TMap<FIntPoint, int32> DefaultMap;
+	TMGridMap<int32> GridMap;
+	Measure(TEXT("TMap<FIntPoint> insertion"), [&Blocks, &DefaultMap]
+	{
+		for (int i = 0; i < Blocks.Num(); ++i)
+		{
+			DefaultMap.Add(Blocks[i], i);
+		}
+		return static_cast<int64>(DefaultMap.Num());
+	});
+	Measure(TEXT("TMGridMap insertion"), [&Blocks, &GridMap]
+	{
+		for (int i = 0; i < Blocks.Num(); ++i)
+		{
+			GridMap.Add(Blocks[i], i);
+		}
+		return static_cast<int64>(GridMap.Num());
+	});
+	Measure(TEXT("TMap<FIntPoint> lookup"), [&Blocks, &DefaultMap]
+	{
+		int64 Sum = 0;
+		for (const auto& Block : Blocks)
+		{
+			Sum += DefaultMap.FindChecked(Block);
+		}
+		return Sum;
+	});
+	Measure(TEXT("TMGridMap lookup"), [&Blocks, &GridMap]
+	{
+		int64 Sum = 0;
+		for (const auto& Block : Blocks)
+		{
+			Sum += GridMap.FindChecked(Block);
+		}
+		return Sum;
+	});
+
+	// Neighbour lookups, the usual access pattern for radius and rect queries
+	const auto MortonBlocks = MGridAddressing::ToMortonArray(Blocks);
+	const auto SumNeighbours = [](const TArray<FIntPoint>& Order, const TMGridMap<int32>& Map)
+	{
+		int64 Sum = 0;
+		for (const auto& Block : Order)
+		{
+			for (const auto& Offset : { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) })
+			{
+				if (const auto* Value = Map.Find(Block + Offset))
+				{
+					Sum += *Value;
+				}
+			}
+		}
+		return Sum;
+	};
+	Measure(TEXT("Neighbours in row order"), [&] { return SumNeighbours(Blocks, GridMap); });
+	Measure(TEXT("Neighbours in Morton order"), [&] { return SumNeighbours(MortonBlocks, GridMap); });
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Benchmarked %d blocks, checksum %lld"), Blocks.Num(), Checksum);
+#endif
+}
+
+void UMConsoleCommandsWorld::CheckRoadCurvesDeterminism(int Quantity)
+{
+#if !UE_BUILD_SHIPPING
+	if (Quantity <= 0)
+		return;
+
+	// The requests come from a fixed stream, so every run and every build checks the very same roads
+	FRandomStream Random(Quantity);
+	TArray<FRoadCurveRequest> Requests;
+	Requests.SetNum(Quantity);
+	for (auto& Request : Requests)
+	{
+		Request.BlockA = FIntPoint(Random.RandRange(-1000, 1000), Random.RandRange(-1000, 1000));
+		Request.BlockB = Request.BlockA + FIntPoint(Random.RandRange(1, 10), Random.RandRange(-10, 10));
+		Request.BlockSize = FVector2D(2000.f, 2000.f);
+		Request.CurveFactor = 0.35f;
+		Request.Seed = UMRoadManager::GetRoadSeed(Request.BlockA, Request.BlockB, ERoadType::MainRoad);
+		for (int i = 0; i < 3; ++i)
+		{
+			const FVector2D Center(Random.FRandRange(-2000000.f, 2000000.f), Random.FRandRange(-2000000.f, 2000000.f));
+			Request.OccupiedAreas.Add(FBox2D(Center - FVector2D(300.f), Center + FVector2D(300.f)));
+		}
+	}
+
+	// Once on the game thread in order, once the same way UMRoadManager::BuildPendingRoads() does it, in reversed order.
+	// The curves must not depend on the thread nor on what was computed before
+	TArray<uint32> SequentialChecksums;
+	SequentialChecksums.Reserve(Quantity);
+	for (const auto& Request : Requests)
+	{
+		const auto Curve = UMRoadManager::ComputeRoadCurve(Request);
+		SequentialChecksums.Add(FCrc::MemCrc32(Curve.GetData(), Curve.Num() * Curve.GetTypeSize()));
+	}
+
+	TArray<uint32> ParallelChecksums;
+	ParallelChecksums.SetNum(Quantity);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Requests, &ParallelChecksums, Quantity]
+	{
+		ParallelFor(Quantity, [&Requests, &ParallelChecksums, Quantity](int32 Index)
+		{
+			const int32 ReversedIndex = Quantity - 1 - Index;
+			const auto Curve = UMRoadManager::ComputeRoadCurve(Requests[ReversedIndex]);
+			ParallelChecksums[ReversedIndex] = FCrc::MemCrc32(Curve.GetData(), Curve.Num() * Curve.GetTypeSize());
+		});
+	}).Wait();
+
+	int MismatchesNumber = 0;
+	for (int i = 0; i < Quantity; ++i)
+	{
+		if (SequentialChecksums[i] != ParallelChecksums[i])
+		{
+			++MismatchesNumber;
+			UE_LOG(LogTopDownTemp, Error, TEXT("Road %s -> %s got different curves in the two builds"), *Requests[i].BlockA.ToString(), *Requests[i].BlockB.ToString());
+		}
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Built %d road curves twice, mismatches: %d"), Quantity, MismatchesNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkOcclusionMaterials(const FString& ClassString, int Quantity)
+{
+#if !UE_BUILD_SHIPPING
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!WorldGenerator || Quantity <= 0)
+		return;
+
+	const auto Class = WorldGenerator->GetClassToSpawn(FName(ClassString));
+	if (!Class || !Class->IsChildOf(AMActor::StaticClass()))
+		return;
+
+	// Every distinct material is at least one draw call, the same materials can be batched
+	const auto CountDistinctMaterials = [](const TArray<AMActor*>& Actors)
+	{
+		TSet<const UMaterialInterface*> Materials;
+		for (const auto Actor : Actors)
+		{
+			TArray<UStaticMeshComponent*> StaticMeshComps;
+			Actor->GetComponents<UStaticMeshComponent>(StaticMeshComps);
+			for (const auto StaticMeshComp : StaticMeshComps)
+			{
+				for (const auto Material : StaticMeshComp->GetMaterials())
+				{
+					Materials.Add(Material);
+				}
+			}
+		}
+		return Materials.Num();
+	};
+
+	// Far away from the players, so nobody sees them and they don't interfere with the grid
+	const FVector Origin(-10000000.f, -10000000.f, 0.f);
+	const int Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Quantity)));
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<AMActor*> Actors;
+	Actors.Reserve(Quantity);
+	double StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < Quantity; ++i)
+	{
+		const FVector Location = Origin + FVector(i % Side, i / Side, 0.f) * 200.f;
+		if (const auto Actor = GetWorld()->SpawnActor<AMActor>(Class, Location, FRotator::ZeroRotator, SpawnParameters))
+		{
+			Actors.Add(Actor);
+		}
+	}
+	const double SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const int SharedMaterialsNumber = CountDistinctMaterials(Actors);
+
+	// What every spawn used to pay
+	StartTime = FPlatformTime::Seconds();
+	for (const auto Actor : Actors)
+	{
+		Actor->CreateDynamicMaterials();
+	}
+	const double CreateDynamicMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const int DynamicMaterialsNumber = CountDistinctMaterials(Actors);
+
+	for (const auto Actor : Actors)
+	{
+		Actor->RestoreSharedMaterials();
+		Actor->AActor::Destroy(); // Not in the grid, so no metadata to remove
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Spawned %d %s in %.2f ms, distinct materials: %d"),
+		Actors.Num(), *ClassString, SpawnMs, SharedMaterialsNumber);
+	UE_LOG(LogTopDownTemp, Display, TEXT("Creating dynamic materials for all of them takes %.2f ms more, distinct materials: %d"),
+		CreateDynamicMs, DynamicMaterialsNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkOcclusionFades(const FString& ClassString, int Quantity)
+{
+#if !UE_BUILD_SHIPPING
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	const auto PlayerController = Cast<AMPlayerController>(GetWorld()->GetFirstPlayerController());
+	if (!WorldGenerator || !PlayerController || Quantity <= 0)
+		return;
+
+	const auto Class = WorldGenerator->GetClassToSpawn(FName(ClassString));
+	if (!Class || !Class->IsChildOf(AMActor::StaticClass()))
+		return;
+
+	// Far away from the players, so nobody sees them and they don't interfere with the grid
+	const FVector Origin(-10000000.f, -10000000.f, 0.f);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<AMActor*> Actors;
+	Actors.Reserve(Quantity);
+	for (int i = 0; i < Quantity; ++i)
+	{
+		if (const auto Actor = GetWorld()->SpawnActor<AMActor>(Class, Origin + FVector(i * 200.f, 0.f, 0.f), FRotator::ZeroRotator, SpawnParameters))
+		{
+			Actors.Add(Actor);
+		}
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	for (const auto Actor : Actors)
+	{
+		PlayerController->SetActorOccludedForDebug(Actor, true);
+	}
+	const double HideMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Simulate a whole fade out at 60 fps
+	constexpr float DeltaTime = 1.f / 60.f;
+	constexpr int FramesNumber = 60;
+	StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < FramesNumber; ++i)
+	{
+		PlayerController->UpdateOpacityForDebug(DeltaTime);
+	}
+	const double FadeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Occluded %d %s in %.3f ms, faded for %d frames in %.3f ms, %.4f ms per frame"),
+		Actors.Num(), *ClassString, HideMs, FramesNumber, FadeMs, FadeMs / FramesNumber);
+
+	// Fade them back in. Finished show transitions have to be dropped, whatever they started from
+	const int OccludedActorsNumberBefore = PlayerController->GetOccludedActorsNumber();
+	for (const auto Actor : Actors)
+	{
+		PlayerController->SetActorOccludedForDebug(Actor, false);
+	}
+	for (int i = 0; i < FramesNumber; ++i)
+	{
+		PlayerController->UpdateOpacityForDebug(DeltaTime);
+	}
+	UE_LOG(LogTopDownTemp, Display, TEXT("Shown back, occluded actors left: %d of %d"),
+		PlayerController->GetOccludedActorsNumber(), OccludedActorsNumberBefore);
+
+	// Destroyed actors are dropped from the fades on the next update
+	for (const auto Actor : Actors)
+	{
+		Actor->AActor::Destroy(); // Not in the grid, so no metadata to remove
+	}
+	PlayerController->UpdateOpacityForDebug(0.f);
+	UE_LOG(LogTopDownTemp, Display, TEXT("Occluded actors left: %d"), PlayerController->GetOccludedActorsNumber());
+#endif
+}
+
+void UMConsoleCommandsWorld::CheckBiomeTransitions()
+{
+#if !UE_BUILD_SHIPPING
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	if (!WorldGenerator || !MetadataManager)
+		return;
+
+	// Flush whatever is queued, the check is about the resolved state
+	WorldGenerator->UpdateBiomeTransitions();
+
+	// Copy of the per block update AMGroundBlock::UpdateBiome used to do, replayed on a shadow state for every spawned block.
+	// Transitions start shown, the way they are spawned
+	TArray<FIntPoint> SpawnedBlocks;
+	for (const auto& [BlockIndex, BlockMetadata] : *MetadataManager->GetGrid())
+	{
+		if (BlockMetadata && IsValid(BlockMetadata->pGroundBlock))
+		{
+			SpawnedBlocks.Add(BlockIndex);
+		}
+	}
+	TMap<TPair<FIntPoint, FIntPoint>, bool> ExpectedHidden;
+	for (const auto& MyIndex : SpawnedBlocks)
+	{
+		const auto IN_Biome = MetadataManager->FindBlock(MyIndex)->Biome;
+		TArray<FIntPoint> AdjacentBlockOffsets{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}; // Left; Right; Top; Bottom
+		for (const auto& AdjacentBlockOffset : AdjacentBlockOffsets)
+		{
+			const auto Block = MetadataManager->FindOrAddBlock({ MyIndex.X + AdjacentBlockOffset.X, MyIndex.Y + AdjacentBlockOffset.Y });
+			if (!Block || Block->Biome == IN_Biome)
+			{
+				ExpectedHidden.Add({MyIndex, AdjacentBlockOffset}, true);
+			}
+			else if (Block->pGroundBlock)
+			{
+				// *-1 because we update the opposite side of the adjacent block
+				ExpectedHidden.Add({MyIndex + AdjacentBlockOffset, AdjacentBlockOffset * -1}, Block->Biome == IN_Biome);
+			}
+		}
+	}
+
+	int BlocksNumber = 0;
+	int MismatchesNumber = 0;
+	for (const auto& BlockIndex : SpawnedBlocks)
+	{
+		const auto GroundBlock = MetadataManager->FindBlock(BlockIndex)->pGroundBlock;
+		++BlocksNumber;
+
+		for (const auto& Offset : AMGroundBlock::TransitionOffsets)
+		{
+			const auto* bFoundExpectedHidden = ExpectedHidden.Find({BlockIndex, Offset});
+			const bool bExpectedHidden = bFoundExpectedHidden && *bFoundExpectedHidden;
+			if (GroundBlock->IsTransitionHidden(Offset) != bExpectedHidden)
+			{
+				++MismatchesNumber;
+				UE_LOG(LogTopDownTemp, Error, TEXT("Block %s transition towards %s is %s, expected %s"), *BlockIndex.ToString(), *Offset.ToString(),
+					bExpectedHidden ? TEXT("shown") : TEXT("hidden"), bExpectedHidden ? TEXT("hidden") : TEXT("shown"));
+			}
+		}
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Checked transitions of %d blocks, mismatches: %d"), BlocksNumber, MismatchesNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintBlockContentStats()
+{
+#if !UE_BUILD_SHIPPING
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	if (!MetadataManager)
+		return;
+
+	int BlocksNumber = 0;
+	int ActorsNumber = 0;
+	int InstancesNumber = 0;
+	int PromotedActorsNumber = 0;
+	for (const auto& [BlockIndex, BlockMetadata] : *MetadataManager->GetGrid())
+	{
+		if (!BlockMetadata || !IsValid(BlockMetadata->pGroundBlock))
+			continue;
+		++BlocksNumber;
+
+		// Grid actors plus whatever PCG spawned and wasn't collapsed
+		TArray<AActor*> AttachedActors;
+		BlockMetadata->pGroundBlock->GetAttachedActors(AttachedActors);
+		const int BlockActorsNumber = BlockMetadata->StaticActors.Num() + BlockMetadata->DynamicActors.Num() + AttachedActors.Num();
+		const int BlockInstancesNumber = BlockMetadata->pGroundBlock->GetInstancesNumber();
+		const int BlockPromotedActorsNumber = BlockMetadata->pGroundBlock->GetPromotedActorsNumber();
+
+		UE_LOG(LogTopDownTemp, Display, TEXT("Block %s: actors %d, instances %d, promoted %d"), *BlockIndex.ToString(),
+			BlockActorsNumber, BlockInstancesNumber, BlockPromotedActorsNumber);
+
+		ActorsNumber += BlockActorsNumber;
+		InstancesNumber += BlockInstancesNumber;
+		PromotedActorsNumber += BlockPromotedActorsNumber;
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Blocks: %d, actors: %d, instances: %d, promoted: %d"),
+		BlocksNumber, ActorsNumber, InstancesNumber, PromotedActorsNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkFlipbookSelection(int FramesNumber, float DegreesPerFrame)
+{
+#if !UE_BUILD_SHIPPING
+	if (FramesNumber <= 0)
+		return;
+
+	TArray<UMRotatableFlipbookComponent*> Flipbooks;
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		TArray<UMRotatableFlipbookComponent*> ActorFlipbooks;
+		It->GetComponents<UMRotatableFlipbookComponent>(ActorFlipbooks);
+		Flipbooks.Append(ActorFlipbooks);
+	}
+	if (Flipbooks.IsEmpty())
+		return;
+
+	int32 ChangesNumberBefore = 0;
+	for (const auto Flipbook : Flipbooks)
+	{
+		ChangesNumberBefore += Flipbook->GetFlipbookChangesNumber();
+	}
+
+	// Each flipbook starts at its own angle, so the sector boundaries are crossed at different frames
+	const double StartTime = FPlatformTime::Seconds();
+	for (int Frame = 0; Frame < FramesNumber; ++Frame)
+	{
+		for (int i = 0; i < Flipbooks.Num(); ++i)
+		{
+			const float ViewingAngle = FRotator::NormalizeAxis(i * 37.f + Frame * DegreesPerFrame);
+			Flipbooks[i]->SetFlipbookByRotation(ViewingAngle);
+		}
+	}
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	int32 ChangesNumber = -ChangesNumberBefore;
+	for (const auto Flipbook : Flipbooks)
+	{
+		ChangesNumber += Flipbook->GetFlipbookChangesNumber();
+	}
+
+	const int CallsNumber = Flipbooks.Num() * FramesNumber;
+	UE_LOG(LogTopDownTemp, Display, TEXT("%d flipbooks for %d frames: %.3f ms, %.4f ms per frame, %d changes out of %d calls"),
+		Flipbooks.Num(), FramesNumber, ElapsedMs, ElapsedMs / FramesNumber, ChangesNumber, CallsNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintShadowStats()
+{
+#if !UE_BUILD_SHIPPING
+	const auto ShadowSubsystem = GetWorld()->GetSubsystem<UMShadowSubsystem>();
+	if (!ShadowSubsystem)
+		return;
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Shadows: %d, updated last frame: %d, updated in total: %lld, frames with the static light: %lld"),
+		ShadowSubsystem->GetShadowsNumber(), ShadowSubsystem->GetLastFrameUpdatesNumber(),
+		ShadowSubsystem->GetTotalUpdatesNumber(), ShadowSubsystem->GetStaticFramesNumber());
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintColorTransitionStats()
+{
+#if !UE_BUILD_SHIPPING
+	const auto ColorTransitionSubsystem = GetWorld()->GetSubsystem<UMColorTransitionSubsystem>();
+	if (!ColorTransitionSubsystem)
+		return;
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Color transitions: %d, transitioning sprites: %d"),
+		ColorTransitionSubsystem->GetActiveTransitionsNumber(), ColorTransitionSubsystem->GetTransitioningSpritesNumber());
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintCharacterTickStats()
+{
+#if !UE_BUILD_SHIPPING
+	int CharactersNumber = 0;
+	int ReducedRateNumber = 0;
+	for (TActorIterator<AMCharacter> It(GetWorld()); It; ++It)
+	{
+		++CharactersNumber;
+		if (It->GetCosmeticTickInterval() > 0.f)
+		{
+			++ReducedRateNumber;
+		}
+	}
+
+	// Counted since the last call, e.g. run it, wait a few seconds after SpawnMob and run again
+	const int64 CosmeticUpdatesNumber = AMCharacter::CosmeticTicksNumber + AMCharacter::IdleSkipsNumber;
+	UE_LOG(LogTopDownTemp, Display, TEXT("Characters: %d, at reduced cosmetic rate: %d. Cosmetic updates: %lld, idle skips: %lld (%.1f%%)"),
+		CharactersNumber, ReducedRateNumber, AMCharacter::CosmeticTicksNumber, AMCharacter::IdleSkipsNumber,
+		CosmeticUpdatesNumber > 0 ? 100.0 * AMCharacter::IdleSkipsNumber / CosmeticUpdatesNumber : 0.0);
+
+	AMCharacter::CosmeticTicksNumber = 0;
+	AMCharacter::IdleSkipsNumber = 0;
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkPerception()
+{
+#if !UE_BUILD_SHIPPING
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	const auto PerceptionSubsystem = GetWorld()->GetSubsystem<UMPerceptionSubsystem>();
+	if (!WorldGenerator || !PerceptionSubsystem)
+		return;
+
+	PerceptionSubsystem->ObserveAll();
+
+	double StartTime = FPlatformTime::Seconds();
+	PerceptionSubsystem->UpdatePerception();
+	const double SharedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// What every mob did on its own before
+	int ScannedActorsNumber = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (TActorIterator<AMCharacter> It(GetWorld()); It; ++It)
+	{
+		const auto StatsModel = It->GetStatsModelComponent();
+		if (!StatsModel)
+			continue;
+		const auto Range = FMath::Max(StatsModel->GetSightRange(), StatsModel->GetForgetEnemyRange());
+		const auto Location = It->GetActorLocation();
+		ScannedActorsNumber += WorldGenerator->GetActorsInRect(Location - FVector(Range, Range, 0.f), Location + FVector(Range, Range, 0.f), true).Num();
+	}
+	const double PerMobMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Characters: %d, observers: %d. Shared perception: %.3f ms, %d pairs checked. Per mob scans: %.3f ms, %d actors scanned"),
+		PerceptionSubsystem->GetCharactersNumber(), PerceptionSubsystem->GetObserversNumber(), SharedMs,
+		PerceptionSubsystem->GetLastPairsNumber(), PerMobMs, ScannedActorsNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintPathRequestStats()
+{
+#if !UE_BUILD_SHIPPING
+	const auto PathRequestSubsystem = GetWorld()->GetSubsystem<UMPathRequestSubsystem>();
+	if (!PathRequestSubsystem)
+		return;
+
+	const int64 RequestsNumber = PathRequestSubsystem->GetIssuedNumber() + PathRequestSubsystem->GetCoalescedNumber();
+	UE_LOG(LogTopDownTemp, Display, TEXT("Path requests: %lld, pathfinding done: %lld, coalesced: %lld (%.1f%%). Queue depth: %d, average latency: %.2f ms"),
+		RequestsNumber, PathRequestSubsystem->GetIssuedNumber(), PathRequestSubsystem->GetCoalescedNumber(),
+		RequestsNumber > 0 ? 100.0 * PathRequestSubsystem->GetCoalescedNumber() / RequestsNumber : 0.0,
+		PathRequestSubsystem->GetQueueDepth(), PathRequestSubsystem->GetAverageLatencyMs());
+
+	PathRequestSubsystem->ResetStats();
+#endif
+}
+
+void UMConsoleCommandsWorld::CheckConversationRegistry(int PlayersNumber)
+{
+#if !UE_BUILD_SHIPPING
+	const auto CommunicationManager = AMGameMode::GetCommunicationManager(this);
+	if (!CommunicationManager)
+		return;
+
+	TArray<AMCharacter*> Characters;
+	for (TActorIterator<AMCharacter> It(GetWorld()); It; ++It)
+	{
+		if (*It != CommunicationManager->GetInterlocutorCharacter())
+		{
+			Characters.Add(*It);
+		}
+	}
+	PlayersNumber = FMath::Min(PlayersNumber, Characters.Num() / 2);
+	if (PlayersNumber <= 0)
+	{
+		UE_LOG(LogTopDownTemp, Display, TEXT("Not enough characters, spawn some with SpawnMob"));
+		return;
+	}
+
+	// The first characters play the players, each speaks to one of the next ones
+	const TArrayView<AMCharacter*> Players(Characters.GetData(), PlayersNumber);
+	for (int i = 0; i < PlayersNumber; ++i)
+	{
+		CommunicationManager->AddConversation(Characters[PlayersNumber + i], Players[i]);
+	}
+
+	int Mismatches = 0;
+	for (int i = PlayersNumber; i < Characters.Num(); ++i)
+	{
+		const auto ExpectedPlayer = i < PlayersNumber * 2 ? Players[i - PlayersNumber] : nullptr;
+		if (CommunicationManager->GetPlayerSpeakingTo(Characters[i]) != ExpectedPlayer)
+		{
+			++Mismatches;
+		}
+	}
+
+	CommunicationManager->InvalidateAttitudes();
+	double StartTime = FPlatformTime::Seconds();
+	for (int i = PlayersNumber; i < Characters.Num(); ++i)
+	{
+		for (const auto Player : Players)
+		{
+			if (CommunicationManager->GetCachedAttitude(Characters[i], Player) != FGenericTeamId::GetAttitude(Characters[i], Player))
+			{
+				++Mismatches;
+			}
+		}
+	}
+	const double ColdMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int i = PlayersNumber; i < Characters.Num(); ++i)
+	{
+		for (const auto Player : Players)
+		{
+			CommunicationManager->GetCachedAttitude(Characters[i], Player);
+		}
+	}
+	const double WarmMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	for (int i = 0; i < PlayersNumber; ++i)
+	{
+		CommunicationManager->RemoveConversation(Characters[PlayersNumber + i]);
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Players: %d, mobs: %d, cached attitudes: %d, mismatches: %d. Attitude checks: %.3f ms cold, %.3f ms warm"),
+		PlayersNumber, Characters.Num() - PlayersNumber, CommunicationManager->GetCachedAttitudesNumber(), Mismatches, ColdMs, WarmMs);
+#endif
+}
+
+void UMConsoleCommandsWorld::TestMeleeHitQuery(int TargetsNumber)
+{
+#if !UE_BUILD_SHIPPING
+	const auto PlayerCharacter = Cast<AMCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
+	if (!PlayerCharacter || !PlayerCharacter->GetAttackPuddleComponent())
+		return;
+	const auto Puddle = PlayerCharacter->GetAttackPuddleComponent();
+
+	const auto TargetLocation = [](const FMMeleeSector& Sector, float OffsetDegrees, float Distance)
+	{
+		const auto Direction = Sector.Direction.GetRotated(OffsetDegrees);
+		return FVector(Sector.Origin + Direction * Distance, 0.f);
+	};
+
+	// Targets just inside and just outside each edge of the sector, plus straight ahead and behind
+	int ChecksNumber = 0, WrapAroundNumber = 0, MismatchesNumber = 0;
+	FMMeleeTargets Targets;
+	TArray<uint8> Hits;
+	constexpr float Distance = 200.f;
+	for (const float Spread : {0.5f, 45.f, 90.f, 120.f, 179.f, 180.f, 181.f, 270.f, 359.f})
+	{
+		Puddle->SetAngle(Spread);
+		Puddle->UpdateRotation();
+		auto Sector = Puddle->GetSector();
+		Sector.Length = Distance * 2.f; // IsCircleWithin doesn't check the length
+		for (const float Radius : {20.f, 60.f, 150.f})
+		{
+			// Angular half width of the target, see MMeleeHitQuery::TestSector
+			const float HalfWidth = FMath::RadiansToDegrees(2.f * FMath::Asin(Radius / (2.f * Distance)));
+			TArray<float> Offsets = {0.f, 180.f};
+			for (const float Epsilon : {-1.f, -0.1f, 0.1f, 1.f})
+			{
+				Offsets.Add(Spread / 2.f + HalfWidth + Epsilon);
+				Offsets.Add(-(Spread / 2.f + HalfWidth + Epsilon));
+			}
+
+			Targets.Reset();
+			for (const float Offset : Offsets)
+			{
+				Targets.Add(nullptr, TargetLocation(Sector, Offset, Distance), Radius);
+			}
+			MMeleeHitQuery::TestSector(Sector, Targets, Hits);
+
+			for (int i = 0; i < Offsets.Num(); ++i)
+			{
+				++ChecksNumber;
+				const auto Location = FVector(Targets.X[i], Targets.Y[i], Puddle->GetComponentLocation().Z);
+				if (Puddle->IsCircleWithin(Location, Radius) == static_cast<bool>(Hits[i]))
+					continue;
+
+				// IsCircleWithin compares absolute angle deltas, which wrap around once the spread and the target width exceed 180
+				if (Spread + HalfWidth > 180.f)
+				{
+					++WrapAroundNumber;
+					continue;
+				}
+				++MismatchesNumber;
+				UE_LOG(LogTopDownTemp, Warning, TEXT("Mismatch: spread %.1f, radius %.0f, offset %.2f, query %d"), Spread, Radius, Offsets[i], Hits[i]);
+			}
+		}
+	}
+
+	// Timing on random targets around the player
+	const auto Sector = Puddle->GetSector();
+	Targets.Reset();
+	for (int i = 0; i < TargetsNumber; ++i)
+	{
+		Targets.Add(nullptr, TargetLocation(Sector, FMath::FRandRange(-180.f, 180.f), FMath::FRandRange(10.f, Sector.Length * 2.f)), FMath::FRandRange(20.f, 60.f));
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	MMeleeHitQuery::TestSector(Sector, Targets, Hits);
+	const double BatchMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	int PerTargetHitsNumber = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int i = 0; i < TargetsNumber; ++i)
+	{
+		// Same targets within the length only, otherwise IsCircleWithin may be given a circle overlapping the puddle origin
+		if (FVector2D::Distance(Sector.Origin, FVector2D(Targets.X[i], Targets.Y[i])) > Targets.Radius[i] * 2.f)
+		{
+			PerTargetHitsNumber += Puddle->IsCircleWithin(FVector(Targets.X[i], Targets.Y[i], 0.f), Targets.Radius[i]);
+		}
+	}
+	const double PerTargetMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Restore the spread the character had
+	Puddle->SetAngle(PlayerCharacter->GetStatsModelComponent()->GetMeleeSpread());
+	Puddle->UpdateRotation();
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Edge checks: %d, mismatches: %d, IsCircleWithin wrap-arounds: %d. %d targets: batch %.3f ms, IsCircleWithin %.3f ms (%d hits)"),
+		ChecksNumber, MismatchesNumber, WrapAroundNumber, TargetsNumber, BatchMs, PerTargetMs, PerTargetHitsNumber);
+#endif
+}
+
+void UMConsoleCommandsWorld::SimulateVirtualMobs(float Hours, int MobsNumber)
+{
+#if !UE_BUILD_SHIPPING
+	FRandomStream Random(MobsNumber);
+
+	TArray<FMVirtualMob> Mobs;
+	Mobs.SetNum(MobsNumber);
+	for (auto& Mob : Mobs)
+	{
+		Mob.Home = FVector2D(Random.FRandRange(-100000.f, 100000.f), Random.FRandRange(-100000.f, 100000.f));
+		Mob.HomeRadius = Random.FRandRange(500.f, 2000.f);
+		Mob.Location = Mob.Home;
+		Mob.Goal = Mob.Home;
+		Mob.Speed = Random.FRandRange(100.f, 300.f);
+	}
+
+	const int StepsNumber = FMath::CeilToInt(Hours * 3600.f / UMVirtualSimulationSubsystem::SimulationInterval);
+	const double StartTime = FPlatformTime::Seconds();
+	for (int Step = 0; Step < StepsNumber; ++Step)
+	{
+		for (auto& Mob : Mobs)
+		{
+			UMVirtualSimulationSubsystem::Advance(Mob, UMVirtualSimulationSubsystem::SimulationInterval, Random);
+		}
+	}
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	int StrayedNumber = 0;
+	double TotalDisplacement = 0.;
+	for (const auto& Mob : Mobs)
+	{
+		const float DistanceToHome = FVector2D::Distance(Mob.Location, Mob.Home);
+		StrayedNumber += DistanceToHome > Mob.HomeRadius + 1.f;
+		TotalDisplacement += DistanceToHome;
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Simulated %.1f hours for %d mobs in %.1f ms (%d steps). Strayed from home: %d, average distance to home: %.0f"),
+		Hours, MobsNumber, ElapsedMs, StepsNumber, StrayedNumber, MobsNumber > 0 ? TotalDisplacement / MobsNumber : 0.);
+
+	if (const auto VirtualSimulationSubsystem = GetWorld()->GetSubsystem<UMVirtualSimulationSubsystem>())
+	{
+		UE_LOG(LogTopDownTemp, Display, TEXT("Virtual mobs in the world: %d, block changes: %d, woken up: %d"),
+			VirtualSimulationSubsystem->GetMobsNumber(), VirtualSimulationSubsystem->GetBlockChangesNumber(), VirtualSimulationSubsystem->GetWokenUpNumber());
+		VirtualSimulationSubsystem->ResetStats();
+	}
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintNPCControllerStats()
+{
+#if !UE_BUILD_SHIPPING
+	static double LastCallTime = FPlatformTime::Seconds();
+	static uint64 LastCallFrame = GFrameCounter;
+	const double Elapsed = FMath::Max(FPlatformTime::Seconds() - LastCallTime, UE_SMALL_NUMBER);
+	const uint64 FramesNumber = GFrameCounter - LastCallFrame;
+	LastCallTime = FPlatformTime::Seconds();
+	LastCallFrame = GFrameCounter;
+
+	int ControllersNumber = 0;
+	int ReducedRateNumber = 0;
+	for (TActorIterator<AMNPCController> It(GetWorld()); It; ++It)
+	{
+		++ControllersNumber;
+		if (It->GetTickInterval() > 0.f)
+		{
+			++ReducedRateNumber;
+		}
+	}
+
+	// Every controller used to tick, compare the rotations and write the turning flags every frame
+	UE_LOG(LogTopDownTemp, Display, TEXT("NPC controllers: %d, at reduced tick rate: %d. Ticks: %.1f/s, turned in: %.1f/s, at full rate there would be about %.1f/s"),
+		ControllersNumber, ReducedRateNumber, AMNPCController::TicksNumber / Elapsed, AMNPCController::TurnedTicksNumber / Elapsed,
+		static_cast<double>(ControllersNumber) * FramesNumber / Elapsed);
+
+	AMNPCController::TicksNumber = 0;
+	AMNPCController::TurnedTicksNumber = 0;
+#endif
+}
+
+void UMConsoleCommandsWorld::BenchmarkSquads(int PacksNumber, int PackSize, bool bUseSquads)
+{
+#if !UE_BUILD_SHIPPING
+	if (const auto SquadSubsystem = GetWorld()->GetSubsystem<UMSquadSubsystem>())
+	{
+		SquadSubsystem->SetEnabled(bUseSquads);
+		SquadSubsystem->ResetStats();
+	}
+	if (const auto PathRequestSubsystem = GetWorld()->GetSubsystem<UMPathRequestSubsystem>())
+	{
+		PathRequestSubsystem->ResetStats();
+	}
+
+	for (int i = 0; i < PacksNumber; ++i)
+	{
+		SpawnMob(CVarToSpawnNightmare.GetValueOnGameThread(), PackSize);
+	}
+#endif
+}
+
+void UMConsoleCommandsWorld::PrintSquadStats()
+{
+#if !UE_BUILD_SHIPPING
+	const auto SquadSubsystem = GetWorld()->GetSubsystem<UMSquadSubsystem>();
+	if (!SquadSubsystem)
+		return;
+
+	// Attackers of the same victim standing inside each other, i.e. what makes them collide and avoid
+	int MembersNumber = 0;
+	int OverlapsNumber = 0;
+	TArray<const AMCharacter*> Attackers;
+	for (TActorIterator<AMCharacter> It(GetWorld()); It; ++It)
+	{
+		if (It->GetStateModelComponent() && (It->GetStateModelComponent()->GetIsFighting() || It->GetStateModelComponent()->GetIsMoving()) && !It->IsPlayerControlled())
+		{
+			Attackers.Add(*It);
+		}
+	}
+	for (int i = 0; i < Attackers.Num(); ++i)
+	{
+		for (int j = i + 1; j < Attackers.Num(); ++j)
+		{
+			if (FVector::Dist2D(Attackers[i]->GetActorLocation(), Attackers[j]->GetActorLocation()) < Attackers[i]->GetRadius() + Attackers[j]->GetRadius())
+			{
+				++OverlapsNumber;
+			}
+		}
+	}
+	for (const auto& [Victim, Squad] : SquadSubsystem->GetSquads())
+	{
+		MembersNumber += Squad.Members.Num();
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Squads %s: %d, members: %d, slot assignments: %d. Moving or fighting mobs: %d, overlapping pairs: %d"),
+		SquadSubsystem->GetEnabled() ? TEXT("on") : TEXT("off"), SquadSubsystem->GetSquads().Num(), MembersNumber,
+		SquadSubsystem->GetAssignmentsNumber(), Attackers.Num(), OverlapsNumber);
+	SquadSubsystem->ResetStats();
+
+	PrintPathRequestStats();
+#endif
+}
+
+void UMConsoleCommandsWorld::CheckNavPointPools()
+{
+#if !UE_BUILD_SHIPPING
+	const auto NavPointPool = GetWorld()->GetSubsystem<UMNavPointPoolSubsystem>();
+	const auto NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavPointPool || !NavigationSystem)
+		return;
+
+	int32 PointsNumber = 0;
+	int32 OffNavMeshNumber = 0;
+	for (const auto& [Key, Pool] : NavPointPool->GetPools())
+	{
+		for (const auto& Point : Pool.Points)
+		{
+			++PointsNumber;
+			// A valid point projects onto itself
+			FNavLocation NavLocation;
+			if (!NavigationSystem->ProjectPointToNavigation(Point, NavLocation) || FVector::DistSquared(Point, NavLocation.Location) > FMath::Square(10.f))
+			{
+				++OffNavMeshNumber;
+				UE_LOG(LogTopDownTemp, Warning, TEXT("Pooled point %s of %s is off the navmesh"), *Point.ToString(), Pool.Outpost.IsValid() ? *Pool.Outpost->GetName() : TEXT("destroyed outpost"));
+			}
+		}
+	}
+
+	const int64 DrawsNumber = NavPointPool->GetHitsNumber() + NavPointPool->GetMissesNumber();
+	UE_LOG(LogTopDownTemp, Display, TEXT("Nav point pools: %d, points: %d, off the navmesh: %d. Draws: %lld, hits: %lld (%.1f%%), projections done: %lld"),
+		NavPointPool->GetPools().Num(), PointsNumber, OffNavMeshNumber, DrawsNumber, NavPointPool->GetHitsNumber(),
+		DrawsNumber > 0 ? 100.0 * NavPointPool->GetHitsNumber() / DrawsNumber : 0.0, NavPointPool->GetProjectionsNumber());
+
+	NavPointPool->ResetStats();
+#endif
+}
+
+void UMConsoleCommandsWorld::MeasureInventoryReplication(int OperationsNumber)
+{
+#if !UE_BUILD_SHIPPING
+	const auto NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver || NetDriver->ClientConnections.IsEmpty())
+	{
+		UE_LOG(LogTopDownTemp, Warning, TEXT("MeasureInventoryReplication needs a listen server with at least one client connected"));
+		return;
+	}
+
+	const auto Character = Cast<AMCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	const auto Inventory = Character ? Character->GetInventoryComponent() : nullptr;
+	if (!Inventory || !Inventory->GetSlots().ContainsByPredicate([](const FSlot& Slot) { return Slot.Item.Quantity > 0; }))
+	{
+		UE_LOG(LogTopDownTemp, Warning, TEXT("MeasureInventoryReplication needs at least one item in the player's inventory"));
+		return;
+	}
+
+	struct FMeasurement
+	{
+		int32 Step = 0;
+		int64 LastOutBytes = 0;
+		int64 IdleBytes = 0;
+		int64 OperationsBytes = 0;
+		FTimerHandle TimerHandle;
+	};
+	const auto Measurement = MakeShared<FMeasurement>();
+	Measurement->LastOutBytes = NetDriver->OutTotalBytes;
+
+	// Each step measures what was sent since the previous one, then does the next operation
+	constexpr int32 IdleSteps = 4;
+	constexpr float StepDuration = 0.5f;
+	const TWeakObjectPtr<UNetDriver> WeakNetDriver = NetDriver;
+	GetWorld()->GetTimerManager().SetTimer(Measurement->TimerHandle, FTimerDelegate::CreateWeakLambda(Inventory, [Measurement, WeakNetDriver, Inventory, OperationsNumber]
+	{
+		if (!WeakNetDriver.IsValid())
+		{
+			Inventory->GetWorld()->GetTimerManager().ClearTimer(Measurement->TimerHandle);
+			return;
+		}
+
+		const int64 OutBytes = WeakNetDriver->OutTotalBytes;
+		const int64 StepBytes = OutBytes - Measurement->LastOutBytes;
+		Measurement->LastOutBytes = OutBytes;
+
+		const int32 Step = Measurement->Step++;
+		if (Step > 0)
+		{
+			(Step <= IdleSteps ? Measurement->IdleBytes : Measurement->OperationsBytes) += StepBytes;
+		}
+
+		if (Step == IdleSteps + OperationsNumber)
+		{
+			Inventory->GetWorld()->GetTimerManager().ClearTimer(Measurement->TimerHandle);
+
+			const double IdleBytesPerStep = static_cast<double>(Measurement->IdleBytes) / IdleSteps;
+			const double BytesPerOperation = OperationsNumber > 0 ? static_cast<double>(Measurement->OperationsBytes) / OperationsNumber : 0.0;
+			UE_LOG(LogTopDownTemp, Display, TEXT("Inventory of %d slots, %d moves to %d clients: %.1f bytes per move (%.1f sent per step, %.1f of them is background traffic)"),
+				Inventory->GetSlots().Num(), OperationsNumber, WeakNetDriver->ClientConnections.Num(),
+				BytesPerOperation - IdleBytesPerStep, BytesPerOperation, IdleBytesPerStep);
+			return;
+		}
+
+		if (Step < IdleSteps)
+			return;
+
+		// Move a whole stack to the first empty slot, so two slots change, same as dragging it with the mouse
+		const auto& Slots = Inventory->GetSlots();
+		const int32 From = Slots.IndexOfByPredicate([](const FSlot& Slot) { return Slot.Item.Quantity > 0; });
+		const int32 EmptySlot = Slots.IndexOfByPredicate([](const FSlot& Slot) { return Slot.Item.Quantity == 0; });
+		if (From == INDEX_NONE)
+			return;
+
+		auto DraggedItem = Inventory->DragItemFromSpecificSlot(From, Slots[From].Item.Quantity);
+		Inventory->StoreDraggedToSpecificSlot(EmptySlot != INDEX_NONE ? EmptySlot : From, DraggedItem);
+	}), StepDuration, true);
+#endif
+}
+
+void UMConsoleCommandsWorld::MeasureInventoryWidgetUpdates(int DragsNumber)
+{
+#if !UE_BUILD_SHIPPING
+	const auto PlayerController = Cast<AMPlayerController>(UGameplayStatics::GetPlayerController(this, 0));
+	const auto InventoryController = PlayerController ? PlayerController->GetInventoryControllerComponent() : nullptr;
+	const auto Character = PlayerController ? Cast<AMCharacter>(PlayerController->GetPawn()) : nullptr;
+	const auto Inventory = Character ? Character->GetInventoryComponent() : nullptr;
+	if (!InventoryController || !Inventory || !Character->HasAuthority())
+	{
+		UE_LOG(LogTopDownTemp, Warning, TEXT("MeasureInventoryWidgetUpdates needs a local player with an inventory on a server or standalone"));
+		return;
+	}
+
+	InventoryController->CreateOrShowInventoryWidget();
+	UMInventorySlotWidget::CreationsNumber = 0;
+	UMInventorySlotWidget::UpdatesNumber = 0;
+
+	int32 DragsDone = 0;
+	const auto& Slots = Inventory->GetSlots();
+	for (int i = 0; i < DragsNumber; ++i)
+	{
+		// Same as dragging a stack with the mouse to the first empty slot, then the widget is refreshed as if it was shown again
+		const int32 From = Slots.IndexOfByPredicate([](const FSlot& Slot) { return Slot.Item.Quantity > 0; });
+		const int32 EmptySlot = Slots.IndexOfByPredicate([](const FSlot& Slot) { return Slot.Item.Quantity == 0; });
+		if (From == INDEX_NONE || EmptySlot == INDEX_NONE)
+			break;
+
+		auto DraggedItem = Inventory->DragItemFromSpecificSlot(From, Slots[From].Item.Quantity);
+		Inventory->StoreDraggedToSpecificSlot(EmptySlot, DraggedItem);
+		InventoryController->UpdateInventoryWidget();
+		++DragsDone;
+	}
+
+	UE_LOG(LogTopDownTemp, Display, TEXT("Inventory of %d slots, %d drags: %.2f slot widgets created and %.2f redrawn per drag"),
+		Slots.Num(), DragsDone, DragsDone > 0 ? static_cast<double>(UMInventorySlotWidget::CreationsNumber) / DragsDone : 0.0,
+		DragsDone > 0 ? static_cast<double>(UMInventorySlotWidget::UpdatesNumber) / DragsDone : 0.0);
+#endif
+}
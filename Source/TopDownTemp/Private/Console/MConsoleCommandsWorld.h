@@ -17,5 +17,107 @@ public:
 
 	UFUNCTION(Exec)
 	void SpawnMob(const FString& MobClassString, int Quantity = 1);
-};
 
+	/** Computes the given number of village layouts with different seeds and logs the timings. Nothing gets spawned */
+	UFUNCTION(Exec)
+	void BenchmarkVillageLayouts(int Quantity = 300);
+
+	/** Logs how many outpost residents are spawned as characters and how many are kept as records */
+	UFUNCTION(Exec)
+	void PrintResidentsStats();
+
+	/** Compares grid containers and index conversions on the given number of blocks around the origin and logs the timings */
+	UFUNCTION(Exec)
+	void BenchmarkGridAddressing(int Quantity = 100000);
+
+	/** Builds a fixed set of road curves twice, sequentially and on worker threads in reversed order, and compares them.\n
+	 * Any difference means a curve depends on the thread or on the order the roads are built in */
+	UFUNCTION(Exec)
+	void CheckRoadCurvesDeterminism(int Quantity = 1000);
+
+	/** Spawns the given number of actors far from the players, e.g. a block full of trees.\n
+	 * Logs the spawn cost and how many distinct materials they render with, with and without dynamic materials */
+	UFUNCTION(Exec)
+	void BenchmarkOcclusionMaterials(const FString& ClassString = "Tree", int Quantity = 256);
+
+	/** Makes the given number of actors occluded at the same time and logs the cost of fading them out and back in */
+	UFUNCTION(Exec)
+	void BenchmarkOcclusionFades(const FString& ClassString = "Tree", int Quantity = 48);
+
+	/** Checks the transitions of every spawned ground block against a replay of the old per block update */
+	UFUNCTION(Exec)
+	void CheckBiomeTransitions();
+
+	/** Logs how much of every ground block content is real actors, collapsed instances and instances promoted back to actors */
+	UFUNCTION(Exec)
+	void PrintBlockContentStats();
+
+	/** Turns every rotatable flipbook in the world, e.g. a crowd spawned with SpawnMob, for the given number of frames.
+	 * Logs the cost of the selection and how many times the flipbooks actually changed */
+	UFUNCTION(Exec)
+	void BenchmarkFlipbookSelection(int FramesNumber = 600, float DegreesPerFrame = 0.5f);
+
+	/** Logs how many 2D shadows are registered and how many of them were turned toward the light */
+	UFUNCTION(Exec)
+	void PrintShadowStats();
+
+	/** Logs how many 2D representations and sprites are in a color transition right now */
+	UFUNCTION(Exec)
+	void PrintColorTransitionStats();
+
+	/** Logs how many characters tick their cosmetic phase at a reduced rate and how many cosmetic updates were skipped as idle.
+	 * Counts since the last call, so spawn a crowd with SpawnMob, call it, wait and call again */
+	UFUNCTION(Exec)
+	void PrintCharacterTickStats();
+
+	/** Makes every character an observer and compares one perception update with the per-mob area scans it replaced.
+	 * Spawn a crowd with SpawnMob first */
+	UFUNCTION(Exec)
+	void BenchmarkPerception();
+
+	/** Logs the path request queue depth, the average latency and how many requests were coalesced since the last call */
+	UFUNCTION(Exec)
+	void PrintPathRequestStats();
+
+	/** Uses some characters as simulated players, makes each speak to a mob and checks the conversation registry and
+	 * the attitude cache against direct attitude checks for every mob and every simulated player */
+	UFUNCTION(Exec)
+	void CheckConversationRegistry(int PlayersNumber = 4);
+
+	/** Compares MMeleeHitQuery with UMAttackPuddleComponent::IsCircleWithin on targets right at the edges of the player's puddle
+	 * for several spreads, then times both on TargetsNumber random targets */
+	UFUNCTION(Exec)
+	void TestMeleeHitQuery(int TargetsNumber = 10000);
+
+	/** Simulates the given number of hours for virtual mobs that exist only as data, no actors are involved.
+	 * Logs the time it took and checks everyone stayed around their homes. Also logs the stats of the real virtual mobs */
+	UFUNCTION(Exec)
+	void SimulateVirtualMobs(float Hours = 4.f, int MobsNumber = 1000);
+
+	/** Logs NPC controller ticks per second since the last call, how many of them the pawn turned in,
+	 * and how many ticks per second there would be at full rate. Also logs how many controllers tick at a reduced rate */
+	UFUNCTION(Exec)
+	void PrintNPCControllerStats();
+
+	/** Spawns packs of Nightmares around the player with SpawnMob. Turns squad slots on or off for comparison.
+	 * Then watch PrintSquadStats while they attack */
+	UFUNCTION(Exec)
+	void BenchmarkSquads(int PacksNumber = 3, int PackSize = 6, bool bUseSquads = true);
+
+	/** Logs the squads, how many attackers overlap each other and the path requests since the last call */
+	UFUNCTION(Exec)
+	void PrintSquadStats();
+
+	/** Checks every pooled villager destination is still on the navmesh and logs the pool hits since the last call */
+	UFUNCTION(Exec)
+	void CheckNavPointPools();
+
+	/** Listen server only. Moves items in the local player's inventory a few times and logs how many bytes each move sends to clients.\n
+	 * Steps are half a second apart, background traffic is measured first and subtracted. Combine with the NetEmulation settings */
+	UFUNCTION(Exec)
+	void MeasureInventoryReplication(int OperationsNumber = 10);
+
+	/** Drags stacks between the local player's inventory slots, refreshing the inventory widget after each drop, and logs how many slot widgets were created and redrawn per drag */
+	UFUNCTION(Exec)
+	void MeasureInventoryWidgetUpdates(int DragsNumber = 10);
+};
@@ -6,7 +6,8 @@
 #include "Characters/MMob.h"
 #include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "Kismet/GameplayStatics.h"
-#include "Managers/MWorldGenerator.h"
+#include "Managers/MPerceptionSubsystem.h"
+#include "Managers/MSquadSubsystem.h"
 #include "NavigationSystem.h"
 #include "Components/MStateModelComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -22,33 +23,27 @@ AMHostileMobController::AMHostileMobController(const FObjectInitializer& ObjectI
 
 void AMHostileMobController::DoIdleBehavior(const UWorld& World, AMCharacter& MyCharacter)
 {
-	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
-	if (!WorldGenerator)
+	const auto PerceptionSubsystem = World.GetSubsystem<UMPerceptionSubsystem>();
+	if (!PerceptionSubsystem)
 	{
 		check(false);
 		return;
 	}
 
-	const auto MyLocation = MyCharacter.GetTransform().GetLocation();
-	//TODO: Optimise the GetActorsInRect() to return elements by Class or Tag, etc.
 	const auto SightRange = MyCharacter.GetStatsModelComponent()->GetSightRange();
-	const auto DynamicActorsInSight = WorldGenerator->GetActorsInRect(MyLocation - FVector(SightRange,SightRange, 0.f), MyLocation + FVector(SightRange,SightRange, 0.f), true);
-
-	if (!DynamicActorsInSight.IsEmpty())
+	for (const auto& Perceived : PerceptionSubsystem->GetPerceived(&MyCharacter))
 	{
-		for (const auto& [Name, DynamicActor] : DynamicActorsInSight)
+		// The closest go first, the rest are out of sight
+		if (Perceived.Distance > SightRange)
+			break;
+
+		//TODO: add a list of enemy/neutral/friends. possibly a map with tags o class names
+		if (const auto Character = Perceived.Character.Get();
+			Character && Character->GetClass()->GetSuperClass()->IsChildOf(AMMemoryator::StaticClass()))
 		{
-			//TODO: add a list of enemy/neutral/friends. possibly a map with tags o class names
-			if (DynamicActor && DynamicActor != this && DynamicActor->GetClass()->GetSuperClass()->IsChildOf(AMMemoryator::StaticClass()))
-			{
-				const auto DistanceToActor = FVector::Distance(DynamicActor->GetTransform().GetLocation(), MyCharacter.GetTransform().GetLocation());
-				if (DistanceToActor <= MyCharacter.GetStatsModelComponent()->GetSightRange())
-				{
-					Victim = Cast<APawn>(DynamicActor);
-					SetChaseBehavior(World, MyCharacter);
-					break;
-				}
-			}
+			Victim = Character;
+			SetChaseBehavior(World, MyCharacter);
+			break;
 		}
 	}
 }
@@ -69,17 +64,17 @@ void AMHostileMobController::DoChaseBehavior(const UWorld& World, AMCharacter& M
 		return;
 	}
 
-	float VictimRadius = 0.f;
-	if (const auto VictimCapsule = Cast<UCapsuleComponent>(Victim->GetRootComponent()))
+	// The slot might be taken or unreachable, don't wait for the move to complete if the victim is already in range
+	const auto SquadSubsystem = World.GetSubsystem<UMSquadSubsystem>();
+	if (SquadSubsystem && SquadSubsystem->GetEnabled() && DistanceToVictim <= GetAttackDistance(MyCharacter) + UMSquadSubsystem::SlotAcceptanceRadius)
 	{
-		VictimRadius = VictimCapsule->GetScaledCapsuleRadius();
+		StopMovement();
+		SetFightBehavior(World, MyCharacter);
+		return;
 	}
 
-	const auto MyMob = Cast<AMMob>(&MyCharacter);
-	const float PileInLength = MyMob ? MyMob->GetPileInLength() : 0.f;
-
 	// For reliability, update the move goal
-	MoveToLocation(Victim->GetActorLocation(), MyCharacter.GetStatsModelComponent()->GetFightRangePlusRadius(MyCharacter.GetRadius()) + VictimRadius - PileInLength, false);
+	RequestChaseMove(World, MyCharacter);
 
 	//TODO: Add a logic to do during chase (shouts, effects, etc.)
 }
@@ -127,6 +122,11 @@ void AMHostileMobController::SetIdleBehavior(const UWorld* World, AMCharacter* M
 	CurrentBehavior = EMobBehaviors::Idle;
 	Victim = nullptr;
 
+	if (const auto SquadSubsystem = GetWorld()->GetSubsystem<UMSquadSubsystem>())
+	{
+		SquadSubsystem->Leave(MyCharacter);
+	}
+
 	OnBehaviorChanged(*MyCharacter);
 }
 
@@ -153,16 +153,12 @@ void AMHostileMobController::SetChaseBehavior(const UWorld& World, AMCharacter&
 		SetFightBehavior(World, MyCharacter);
 	});
 
-	float VictimRadius = 0.f;
-	if (const auto VictimCapsule = Cast<UCapsuleComponent>(Victim->GetRootComponent()))
+	if (const auto SquadSubsystem = World.GetSubsystem<UMSquadSubsystem>())
 	{
-		VictimRadius = VictimCapsule->GetScaledCapsuleRadius();
+		SquadSubsystem->Join(Victim, &MyCharacter);
 	}
 
-	const auto MyMob = Cast<AMMob>(&MyCharacter);
-	const float PileInLength = MyMob ? MyMob->GetPileInLength() : 0.f;
-
-	MoveToLocation(Victim->GetActorLocation(), MyCharacter.GetStatsModelComponent()->GetFightRangePlusRadius(MyCharacter.GetRadius()) + VictimRadius - PileInLength, false);
+	RequestChaseMove(World, MyCharacter);
 
 	OnBehaviorChanged(MyCharacter);
 }
@@ -195,6 +191,12 @@ void AMHostileMobController::SetRetreatBehavior(const UWorld& World, AMCharacter
 
 	CurrentBehavior = EMobBehaviors::Retreat;
 
+	// Free the slot while running away, the chase after the retreat joins again
+	if (const auto SquadSubsystem = World.GetSubsystem<UMSquadSubsystem>())
+	{
+		SquadSubsystem->Leave(&MyCharacter);
+	}
+
 	if (!Victim)
 	{
 		// We need to know who are we running from
@@ -215,11 +217,13 @@ void AMHostileMobController::SetRetreatBehavior(const UWorld& World, AMCharacter
 	if (UNavigationSystemV1::K2_ProjectPointToNavigation(const_cast<UWorld*>(&World), RetreatLocation, NavigatedRetreatLocation, nullptr, nullptr))
 	{
 		OnMoveCompletedDelegate.Unbind();
+		// The chase move may still be running or queued, its completion must not trigger the retreat's one
+		StopMovement();
 		OnMoveCompletedDelegate.BindLambda([this, &World, &MyCharacter]
 		{
 			SetChaseBehavior(World, MyCharacter);
 		});
-		MoveToLocation(NavigatedRetreatLocation);
+		RequestMoveToLocation(NavigatedRetreatLocation);
 	}
 	else
 	{
@@ -230,6 +234,34 @@ void AMHostileMobController::SetRetreatBehavior(const UWorld& World, AMCharacter
 	OnBehaviorChanged(MyCharacter);
 }
 
+float AMHostileMobController::GetAttackDistance(const AMCharacter& MyCharacter) const
+{
+	float VictimRadius = 0.f;
+	if (const auto VictimCapsule = Cast<UCapsuleComponent>(Victim->GetRootComponent()))
+	{
+		VictimRadius = VictimCapsule->GetScaledCapsuleRadius();
+	}
+
+	const auto MyMob = Cast<AMMob>(&MyCharacter);
+	const float PileInLength = MyMob ? MyMob->GetPileInLength() : 0.f;
+
+	return MyCharacter.GetStatsModelComponent()->GetFightRangePlusRadius(MyCharacter.GetRadius()) + VictimRadius - PileInLength;
+}
+
+void AMHostileMobController::RequestChaseMove(const UWorld& World, AMCharacter& MyCharacter)
+{
+	const auto SquadSubsystem = World.GetSubsystem<UMSquadSubsystem>();
+	if (SquadSubsystem && SquadSubsystem->GetEnabled())
+	{
+		// Each member of the pack goes to its own slot around the victim instead of all piling in the same point
+		RequestMoveToLocation(SquadSubsystem->GetSlotLocation(&MyCharacter, GetAttackDistance(MyCharacter)), UMSquadSubsystem::SlotAcceptanceRadius, false);
+	}
+	else
+	{
+		RequestMoveToLocation(Victim->GetActorLocation(), GetAttackDistance(MyCharacter), false);
+	}
+}
+
 void AMHostileMobController::OnBehaviorChanged(AMCharacter& MyCharacter)
 {
 	// TODO: Consider removing this function
@@ -267,22 +299,20 @@ void AMHostileMobController::OnHit()
 
 	// Make sure we rotate towards victim at the moment of hit
 	DoFightBehavior(*GetWorld(), *MyCharacter);
-	MyCharacter->Tick(0.f);
+	MyCharacter->TickCosmetic(0.f);
 	AttackPuddleComponent->UpdateRotation();
 
-	TArray<AActor*> OutActors;
-	UKismetSystemLibrary::BoxOverlapActors(GetWorld(), AttackPuddleComponent->GetComponentLocation(), AttackPuddleComponent->Bounds.BoxExtent, {UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_Pawn)}, AMCharacter::StaticClass(), {MyCharacter}, OutActors);
-	for (const auto Actor : OutActors)
-	{
-		if (!Actor)
-			continue;
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!WorldGenerator) { check(false); return; }
 
-		if (const auto CapsuleComponent = Cast<UCapsuleComponent>(Actor->GetRootComponent()))
+	const auto Sector = AttackPuddleComponent->GetSector();
+	MMeleeHitQuery::GatherTargets(*WorldGenerator, Sector, MyCharacter, HitTargets);
+	MMeleeHitQuery::TestSector(Sector, HitTargets, HitResults);
+	for (int32 i = 0; i < HitTargets.Num(); ++i)
+	{
+		if (HitResults[i])
 		{
-			if (AttackPuddleComponent->IsCircleWithin(Actor->GetActorLocation(), CapsuleComponent->GetScaledCapsuleRadius()))
-			{
-				Actor->TakeDamage(MyCharacter->GetStatsModelComponent()->GetStrength(), FDamageEvent(), this, MyCharacter);
-			}
+			HitTargets.Actors[i]->TakeDamage(MyCharacter->GetStatsModelComponent()->GetStrength(), FDamageEvent(), this, MyCharacter);
 		}
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MMobControllerBase.h"
+#include "Helpers/MMeleeHitQuery.h"
 #include "MHostileMobController.generated.h"
 
 class AMOutpostHouse;
@@ -40,6 +41,17 @@ private:
 
 	virtual void OnBehaviorChanged(AMCharacter& MyCharacter) override;
 
+	/** Distance to the victim's center to strike from */
+	float GetAttackDistance(const AMCharacter& MyCharacter) const;
+
+	/** Moves to the slot around the victim given by UMSquadSubsystem */
+	void RequestChaseMove(const UWorld& World, AMCharacter& MyCharacter);
+
 	UPROPERTY()
 	APawn* Victim;
+
+	/** Kept between hits so the arrays keep their memory */
+	FMMeleeTargets HitTargets;
+
+	TArray<uint8> HitResults;
 };
\ No newline at end of file
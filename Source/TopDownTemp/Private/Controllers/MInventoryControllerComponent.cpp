@@ -89,9 +89,22 @@ void UMInventoryControllerComponent::Server_TrySwapDraggedWithSpecificSlot_Imple
 	check(false);
 }
 
+void UMInventoryControllerComponent::Server_TrySortInventory_Implementation(FMUid InventoryOwnerActorUid)
+{
+	if (auto* InventoryOwnerMetadata = AMGameMode::GetMetadataManager(this)->Find(InventoryOwnerActorUid))
+	{
+		if (auto* Inventory = InventoryOwnerMetadata->Actor->GetComponentByClass<UMInventoryComponent>())
+		{
+			Inventory->Sort();
+			return;
+		}
+	}
+	check(false);
+}
+
 void UMInventoryControllerComponent::AddInventoryForPickUp(const UMInventoryComponent* ReplicatedInventory)
 {
-	if (ReplicatedInventory->GetSlotsConst().IsEmpty() || !GetWorld() || !GetWorld()->GetFirstPlayerController())
+	if (ReplicatedInventory->GetSlots().IsEmpty() || !GetWorld() || !GetWorld()->GetFirstPlayerController())
 		return;
 
 	if (InventoriesToRepresent.IsEmpty())
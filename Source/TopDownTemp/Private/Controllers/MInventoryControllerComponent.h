@@ -44,6 +44,9 @@ public:
 	UFUNCTION(BlueprintCallable, Server, Reliable)
 	void Server_TrySwapDraggedWithSpecificSlot(FMUid InventoryOwnerActorUid, int SlotNumberInArray);
 
+	UFUNCTION(BlueprintCallable, Server, Reliable)
+	void Server_TrySortInventory(FMUid InventoryOwnerActorUid);
+
 	void AddInventoryForPickUp(const UMInventoryComponent* ReplicatedInventory);
 
 	void RemoveInventoryForPickUp(const UMInventoryComponent* ReplicatedInventory);
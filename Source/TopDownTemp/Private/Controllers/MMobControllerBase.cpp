@@ -2,7 +2,7 @@
 #include "Characters/MCharacter.h"
 #include "Framework/MGameMode.h"
 #include "Managers/MCommunicationManager.h"
-#include "Kismet/GameplayStatics.h"
+#include "Managers/MPathRequestSubsystem.h"
 #include "Navigation/PathFollowingComponent.h"
 
 AMMobControllerBase::AMMobControllerBase(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -35,7 +35,7 @@ void AMMobControllerBase::Tick(float DeltaSeconds)
 	if (CurrentBehavior == EMobBehaviors::Idle)
 	{
 		// Communication check
-		if (IsPlayerSpeakingToMe() && GetAttitudeToPlayer() != ETeamAttitude::Hostile)
+		if (const auto SpeakingPlayer = GetPlayerSpeakingToMe(); SpeakingPlayer && GetAttitudeToPlayer(SpeakingPlayer) != ETeamAttitude::Hostile)
 		{
 			SetIdleBehavior(pWorld, MyCharacter); // To reset all possible idle timers
 			return; // If the mob is having a conversation with player, do nothing and keep standing
@@ -46,7 +46,7 @@ void AMMobControllerBase::Tick(float DeltaSeconds)
 	if (CurrentBehavior == EMobBehaviors::Walk)
 	{
 		// Communication check
-		if (IsPlayerSpeakingToMe() && GetAttitudeToPlayer() != ETeamAttitude::Hostile)
+		if (const auto SpeakingPlayer = GetPlayerSpeakingToMe(); SpeakingPlayer && GetAttitudeToPlayer(SpeakingPlayer) != ETeamAttitude::Hostile)
 		{
 			SetIdleBehavior(pWorld, MyCharacter); // To reset all possible idle timers
 			return; // If the mob is having a conversation with player, do nothing and keep standing
@@ -103,35 +103,59 @@ void AMMobControllerBase::OnMoveCompleted(FAIRequestID RequestID, const FPathFol
 	OnMoveCompletedDelegate.Execute();
 }
 
-bool AMMobControllerBase::IsPlayerSpeakingToMe()
+void AMMobControllerBase::RequestMoveToLocation(const FVector& Goal, float AcceptanceRadius, bool bStopOnOverlap)
 {
-	const auto MyCharacter = Cast<AMCharacter>(GetPawn());
-	if (!MyCharacter) { check(false); return false; }
+	if (const auto PathRequestSubsystem = GetWorld()->GetSubsystem<UMPathRequestSubsystem>())
+	{
+		PathRequestSubsystem->RequestMove(this, Goal, AcceptanceRadius, bStopOnOverlap);
+	}
+	else
+	{
+		check(false);
+		MoveToLocation(Goal, AcceptanceRadius, bStopOnOverlap);
+	}
+}
 
-	const auto pWorld = GetWorld();
-	if (!pWorld) { check(false); return false; }
+void AMMobControllerBase::StopMovement()
+{
+	if (const auto PathRequestSubsystem = GetWorld()->GetSubsystem<UMPathRequestSubsystem>())
+	{
+		PathRequestSubsystem->CancelMove(this);
+	}
+
+	Super::StopMovement();
+}
+
+void AMMobControllerBase::ResetBehavior()
+{
+	if (const auto MyCharacter = Cast<AMCharacter>(GetPawn()))
+	{
+		SetIdleBehavior(GetWorld(), MyCharacter);
+	}
+}
+
+AMCharacter* AMMobControllerBase::GetPlayerSpeakingToMe() const
+{
+	const auto MyCharacter = Cast<AMCharacter>(GetPawn());
+	if (!MyCharacter) { check(false); return nullptr; }
 
 	if (const auto CommunicationManager = AMGameMode::GetCommunicationManager(this))
 	{
-		if (const auto InterlocutorCharacter = CommunicationManager->GetInterlocutorCharacter(); InterlocutorCharacter && InterlocutorCharacter == MyCharacter)
-		{
-			return true;
-		}
+		return CommunicationManager->GetPlayerSpeakingTo(MyCharacter);
 	}
 
-	return false;
+	return nullptr;
 }
 
-ETeamAttitude::Type AMMobControllerBase::GetAttitudeToPlayer() const
+ETeamAttitude::Type AMMobControllerBase::GetAttitudeToPlayer(const AActor* Player) const
 {
-	const auto pWorld = GetWorld();
 	const auto MyMCharacter = Cast<AMCharacter>(GetPawn());
-	if (!pWorld || !MyMCharacter) { check(false); return ETeamAttitude::Type::Neutral; }
+	if (!MyMCharacter || !Player) { check(false); return ETeamAttitude::Type::Neutral; }
 
-	if (const auto PlayerCharacter = UGameplayStatics::GetPlayerCharacter(pWorld, 0))
+	if (const auto CommunicationManager = AMGameMode::GetCommunicationManager(this))
 	{
-		return FGenericTeamId::GetAttitude(GetPawn(), PlayerCharacter);
+		return CommunicationManager->GetCachedAttitude(MyMCharacter, Player);
 	}
-	check(false);
-	return ETeamAttitude::Type::Neutral;
+
+	return FGenericTeamId::GetAttitude(MyMCharacter, Player);
 }
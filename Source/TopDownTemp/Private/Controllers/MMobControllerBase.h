@@ -23,6 +23,8 @@ class TOPDOWNTEMP_API AMMobControllerBase : public AAIController, public IMInter
 	GENERATED_UCLASS_BODY()
 
 public:
+	/** Drops whatever the mob was doing and makes it idle. E.g. when it was moved while disabled */
+	void ResetBehavior();
 
 protected:
 	/** High priority logic to be performed before behavior processing. I.e. check for enemies nearby */
@@ -30,10 +32,17 @@ protected:
 
 	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
 
-	bool IsPlayerSpeakingToMe(); //TODO: Move to the AMCommunicationManager
+	/** The player having a conversation with the controlled pawn, nullptr if none. See AMCommunicationManager */
+	AMCharacter* GetPlayerSpeakingToMe() const;
 
-	/** Helper function to get controlled pawn's attitude to the current local player. */
-	ETeamAttitude::Type GetAttitudeToPlayer() const;
+	/** Helper function to get controlled pawn's attitude to the given player. Cached by AMCommunicationManager */
+	ETeamAttitude::Type GetAttitudeToPlayer(const AActor* Player) const;
+
+	/** Use it instead of MoveToLocation, so the request goes through UMPathRequestSubsystem */
+	void RequestMoveToLocation(const FVector& Goal, float AcceptanceRadius = -1.f, bool bStopOnOverlap = true);
+
+	/** Also drops the move request that wasn't served yet */
+	virtual void StopMovement() override;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = BehaviorParameters, meta=(AllowPrivateAccess = true))
 	EMobBehaviors CurrentBehavior = EMobBehaviors::Idle;
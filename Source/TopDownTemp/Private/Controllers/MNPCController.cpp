@@ -10,12 +10,16 @@
 #include "StationaryActors/Outposts/MOutpostHouse.h"
 #include "StationaryActors/Outposts/OutpostGenerators/MOutpostGenerator.h"
 
+#if !UE_BUILD_SHIPPING
+int64 AMNPCController::TicksNumber = 0;
+int64 AMNPCController::TurnedTicksNumber = 0;
+#endif
+
 AMNPCController::AMNPCController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
-	// All NPCs ticks reduced to half a second by default
+	// The tick rate follows the pawn's significance, see UpdateTickInterval()
 	PrimaryActorTick.bStartWithTickEnabled = true;
 	PrimaryActorTick.bCanEverTick = true;
-	//PrimaryActorTick.TickInterval = 0.5f; // TODO: Lower tick rate basing on distance/whatnot
 }
 
 FGenericTeamId AMNPCController::GetGenericTeamId() const
@@ -50,7 +54,7 @@ void AMNPCController::OnPossess(APawn* InPawn)
 	{
 		// Currently state data isn't used in trees, but it's going to be useful at some point
 		MCharacter->OnStateModelUpdatedDelegate.AddUObject(this, &AMNPCController::CopyStateVariablesToBlackboard);
-		MCharacter->OnMovedInDelegate.AddLambda([this](const AMOutpostHouse* NewHouse)
+		MCharacter->OnMovedInDelegate.AddWeakLambda(this, [this](const AMOutpostHouse* NewHouse)
 		{
 			if (NewHouse)
 			{
@@ -62,9 +66,8 @@ void AMNPCController::OnPossess(APawn* InPawn)
 				}
 			}
 		});
-		MCharacter->GetCommunicationComponent()->OnInterlocutorChangedDelegate.AddLambda([this](AMCharacter* Interlocutor)
+		MCharacter->GetCommunicationComponent()->OnInterlocutorChangedDelegate.AddWeakLambda(this, [this](AMCharacter* Interlocutor)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Interlocutor is set"));
 			Blackboard->SetValueAsObject(TEXT("Interlocutor"), Interlocutor);
 		});
 	}
@@ -76,6 +79,7 @@ void AMNPCController::OnUnPossess()
 	{
 		MCharacter->OnMovedInDelegate.RemoveAll(this);
 		MCharacter->OnStateModelUpdatedDelegate.RemoveAll(this);
+		MCharacter->GetCommunicationComponent()->OnInterlocutorChangedDelegate.RemoveAll(this);
 	}
 	Super::OnUnPossess();
 }
@@ -112,20 +116,47 @@ void AMNPCController::OnTurnAround() const
 	}
 }
 
-void AMNPCController::Tick(float DeltaSeconds)
+void AMNPCController::UpdateTickInterval(const AMCharacter& MyCharacter)
 {
-	Super::Tick(DeltaSeconds);
-	if (GetPawn() && GetPawn()->GetActorRotation() != LastRotation)
+	const float Interval = MyCharacter.GetClosestPlayerDistanceSquared(false) > FMath::Square(SignificantDistance) ? FarTickInterval : 0.f;
+	if (PrimaryActorTick.TickInterval != Interval)
 	{
-		RotationDelta = GetPawn()->GetActorRotation() - LastRotation;
-		OnTurnAround();
-		LastRotation = GetPawn()->GetActorRotation();
+		SetActorTickInterval(Interval);
 	}
-	else
+}
+
+void AMNPCController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+#if !UE_BUILD_SHIPPING
+	++TicksNumber;
+#endif
+
+	const auto* MyCharacter = Cast<AMCharacter>(GetPawn());
+	if (!MyCharacter)
+		return;
+
+	UpdateTickInterval(*MyCharacter);
+
+	const auto Rotation = MyCharacter->GetActorRotation();
+	if (Rotation == LastRotation)
 	{
-		const auto* MyCharacter = Cast<AMCharacter>(GetPawn());
-		auto* StateModel = MyCharacter->GetStateModelComponent();
-		StateModel->SetIsTurningRight(false);
-		StateModel->SetIsTurningLeft(false);
+		// Lowered once when the pawn stops turning, not every tick
+		if (bTurning)
+		{
+			auto* StateModel = MyCharacter->GetStateModelComponent();
+			StateModel->SetIsTurningRight(false);
+			StateModel->SetIsTurningLeft(false);
+			bTurning = false;
+		}
+		return;
 	}
+#if !UE_BUILD_SHIPPING
+	++TurnedTicksNumber;
+#endif
+
+	RotationDelta = Rotation - LastRotation;
+	OnTurnAround();
+	LastRotation = Rotation;
+	bTurning = true;
 }
@@ -5,6 +5,7 @@
 #include "MInterfaceMobController.h"
 #include "MNPCController.generated.h"
 
+class AMCharacter;
 class UMStateModelComponent;
 class UAIPerceptionComponent;
 
@@ -19,6 +20,17 @@ class TOPDOWNTEMP_API AMNPCController : public AAIController
 
 public:
 
+public: // For debugging
+#if !UE_BUILD_SHIPPING
+	/** Controller ticks actually run since the last reset */
+	static int64 TicksNumber;
+
+	/** Ticks the pawn had turned in, i.e. the only ones the rotation was compared and the turning flags were written in */
+	static int64 TurnedTicksNumber;
+#endif
+
+	float GetTickInterval() const { return PrimaryActorTick.TickInterval; }
+
 protected: // IGenericTeamAgentInterface
 	virtual FGenericTeamId GetGenericTeamId() const override;
 	virtual ETeamAttitude::Type GetTeamAttitudeTowards(const AActor& Other) const override;
@@ -36,11 +48,23 @@ protected:
 	/** Triggers by rotating, i.e. DeltaRotation is non zero */
 	void OnTurnAround() const;
 
+	/** Ticks at FarTickInterval while no player is within SignificantDistance, the same significance the pawn's cosmetic phase uses */
+	void UpdateTickInterval(const AMCharacter& MyCharacter);
+
+	UPROPERTY(EditDefaultsOnly, Category=Significance)
+	float SignificantDistance = 2000.f;
+
+	UPROPERTY(EditDefaultsOnly, Category=Significance)
+	float FarTickInterval = 0.25f;
+
 private:
 	virtual void Tick(float DeltaSeconds) override;
 
 	bool bEmbarked = false;
 
+	/** Whether the turning flags were raised, so they are lowered only once the pawn stops turning */
+	bool bTurning = false;
+
 	FRotator LastRotation;
 
 	// Every time rotation changes, calculate the delta from previous frame
@@ -22,6 +22,7 @@
 #include "Framework/MGameMode.h"
 #include "Controllers/MInventoryControllerComponent.h"
 #include "StationaryActors/MActor.h"
+#include "StationaryActors/MGroundBlock.h"
 
 AMPlayerController::AMPlayerController(const FObjectInitializer& ObjectInitializer) :
 	Super(ObjectInitializer),
@@ -82,6 +83,9 @@ void AMPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Enough for a dense forest, so the fades don't allocate while playing
+	OccludedActors.Reserve(64);
+
 	if (DeferredPawnToPossess)
 	{
 		Possess(DeferredPawnToPossess);
@@ -96,6 +100,54 @@ void AMPlayerController::BeginPlay()
 		ActiveCapsuleComponent = Cast<UCapsuleComponent>(
 			GetPawn()->GetComponentByClass(UCapsuleComponent::StaticClass()));
 	}
+
+	// Gameplay happens on the server, clients keep rendering their own instances
+	if (HasAuthority())
+	{
+		GetWorld()->GetTimerManager().SetTimer(GameplayPromotionTimerHandle, this, &AMPlayerController::PromoteInstancesAroundPawn, 0.25f, true);
+	}
+}
+
+void AMPlayerController::PromoteInstancesAroundPawn()
+{
+	if (!HasAuthority())
+		return;
+
+	// Cosmetic, so the actors go back to instances as soon as no pawn is around them anymore
+	for (auto It = ProximityPromotedActors.CreateIterator(); It; ++It)
+	{
+		const auto MActor = It->Get();
+		if (MActor && IsAnyPawnNearby(MActor->GetActorLocation()))
+			continue;
+
+		if (const auto GroundBlock = MActor ? Cast<AMGroundBlock>(MActor->GetAttachParentActor()) : nullptr)
+		{
+			GroundBlock->DemoteActor(MActor);
+		}
+		It.RemoveCurrent();
+	}
+
+	if (const auto MyPawn = GetPawn())
+	{
+		for (const auto MActor : AMGroundBlock::PromoteInstancesAround(this, MyPawn->GetActorLocation(), GameplayPromotionRadius, false))
+		{
+			ProximityPromotedActors.Add(MActor);
+		}
+	}
+}
+
+bool AMPlayerController::IsAnyPawnNearby(const FVector& Location) const
+{
+	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const auto PlayerController = It->Get();
+		if (const auto Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+			Pawn && FVector::DistSquared2D(Pawn->GetActorLocation(), Location) <= FMath::Square(GameplayPromotionRadius))
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
 bool AMPlayerController::IsMovingByAI() const
@@ -172,6 +224,8 @@ void AMPlayerController::PlayerTick(float DeltaTime)
 {
 	Super::PlayerTick(DeltaTime);
 
+	UpdateOpacity(DeltaTime);
+
 	// Keep updating the destination every tick while desired
 	// TODO: support this if needed, right now it doesn't work
 	/*if (bMoveToMouseCursor)
@@ -342,6 +396,9 @@ void AMPlayerController::OnToggleTurnAroundReleased()
 
 void AMPlayerController::OnToggleFightPressed()
 {
+	// Whatever is harvested must be a real actor by the time the attack lands
+	PromoteInstancesAroundPawn();
+
 	if (const auto MyCharacter = Cast<AMCharacter>(GetPawn()); MyCharacter && !MyCharacter->GetStateModelComponent()->GetIsFighting())
 	{
 		MyCharacter->GetStateModelComponent()->SetIsFighting(true);
@@ -350,6 +407,15 @@ void AMPlayerController::OnToggleFightPressed()
 
 void AMPlayerController::OnLeftMouseClick()
 {
+	// Clicked decorative content is rendered as instances, give the interaction a real actor
+	if (FHitResult InstanceHitResult; GetHitResultUnderCursor(ECC_Visibility, true, InstanceHitResult))
+	{
+		if (const auto GroundBlock = Cast<AMGroundBlock>(InstanceHitResult.GetActor()))
+		{
+			GroundBlock->PromoteInstance(InstanceHitResult.GetComponent(), InstanceHitResult.Item, true);
+		}
+	}
+
 	FHitResult HitResult;
 	if (GetHitResultUnderCursorForObjects({UEngineTypes::ConvertToObjectType(ECC_Pawn)}, true, HitResult))
 	{
@@ -378,6 +444,8 @@ bool AMPlayerController::ProcessConsoleExec(const TCHAR* Cmd, FOutputDevice& Ar,
 
 void AMPlayerController::SyncOccludedActors()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMPlayerController::SyncOccludedActors);
+
 	if (!ShouldCheckCameraOcclusion())
 	{
 		return;
@@ -386,11 +454,7 @@ void AMPlayerController::SyncOccludedActors()
 	FVector Start = ActiveCamera->GetComponentLocation();
 	FVector End = GetPawn()->GetActorLocation();
 
-	TArray<TEnumAsByte<EObjectTypeQuery>> CollisionObjectTypes;
-	CollisionObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECC_OccludedTerrain));
-
-	TArray<AActor*> ActorsToIgnore; // TODO: Add configuration to ignore actor types
-	TArray<FHitResult> OutHits;
+	static const TArray<AActor*> ActorsToIgnore; // TODO: Add configuration to ignore actor types
 
 	auto ShouldDebug = DebugLineTraces ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None;
 
@@ -400,122 +464,126 @@ void AMPlayerController::SyncOccludedActors()
 	//TODO: Try using BoxTraceMulti as the horizontal shape will fit the screen size while checking occlusion.
 	UKismetSystemLibrary::SphereTraceMulti(
 	GetWorld(), Start, End, ActiveCapsuleComponent->GetScaledCapsuleRadius() * CapsulePercentageForTrace,
-	UEngineTypes::ConvertToTraceType(ECC_OccludedTerrain), true, ActorsToIgnore, ShouldDebug, OutHits, true);
+	UEngineTypes::ConvertToTraceType(ECC_OccludedTerrain), true, ActorsToIgnore, ShouldDebug, OcclusionHits, true);
 
-	// The list of actors hit by the line trace, that means that they are occluded from view
-	TSet<const AActor*> ActorsJustOccluded;
-	if (!OutHits.IsEmpty())
+	for (auto& OccludedActor : OccludedActors)
 	{
-		// Hide actors that are occluded by the camera
-		for (FHitResult Hit : OutHits)
+		OccludedActor.bOccluding = false;
+	}
+
+	// Hide actors that are occluded by the camera
+	for (const FHitResult& Hit : OcclusionHits)
+	{
+		AMActor* HitMActor = Cast<AMActor>(Hit.GetActor());
+		// Decorative content is rendered by the block as instances, those need a real actor to be faded
+		if (const auto GroundBlock = Cast<AMGroundBlock>(HitMActor))
 		{
-			if (const AMActor* HitMActor = Cast<AMActor>(Hit.GetActor()))
-			{
-				HideOccludedActor(HitMActor, Hit.Distance);
-				ActorsJustOccluded.Add(HitMActor);
-			}
+			HitMActor = GroundBlock->PromoteInstance(Hit.GetComponent(), Hit.Item);
+		}
+		if (HitMActor)
+		{
+			HideOccludedActor(HitMActor, Hit.Distance);
 		}
 	}
-	TArray<FName> RemoveKeyList;
+
 	// Show actors that are currently hidden but that are not occluded by the camera anymore
-	for (auto& [Name, OccludedActor] : OccludedActors)
+	for (auto& OccludedActor : OccludedActors)
 	{
-		if (!ActorsJustOccluded.Contains(OccludedActor->MActor) && OccludedActor->TargetOpacity != 1.f)
+		if (!OccludedActor.bOccluding && OccludedActor.TargetOpacity != 1.f)
 		{
 			ShowOccludedActor(OccludedActor);
 		}
-		if (OccludedActor->PendingKill) // Separate condition, because it can be removed only after the transition finishes
-		{
-			RemoveKeyList.Add(Name);
-		}
 	}
-
-	for (const auto Name : RemoveKeyList)
-		OccludedActors.Remove(Name);
 }
 
-
-void AMPlayerController::UpdateOpacity(UCameraOccludedActor* OccludedActor)
+void AMPlayerController::UpdateOpacity(float DeltaTime)
 {
-	if (!IsValid(OccludedActor))
-		return;
-	if (!IsValid(OccludedActor->MActor)) // Valid check
-	{
-		OccludedActors.Remove(FName(OccludedActor->Name));
-		GetWorld()->GetTimerManager().ClearTimer(OccludedActor->OpacityTimerHandle);
-		return;
-	}
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMPlayerController::UpdateOpacity);
 
-	OccludedActor->TransitionRemainTime -= GetWorld()->GetTimeSeconds() - OccludedActor->LastUpdateTime;
-	OccludedActor->TransitionRemainTime = FMath::Clamp(OccludedActor->TransitionRemainTime, 0.f, OpacityTransitionDuration);
-	OccludedActor->LastUpdateTime = GetWorld()->GetTimeSeconds();
+	static const FName OccludedOpacityName("OccludedOpacity");
 
-	bool bAtLeastOneParamHasOpacity = false; // If object doesn't support opacity, remove its handler
-	// Calculate New Opacity
-	for (const auto& [StaticMesh, DynamicMaterialArrayWrapper] : OccludedActor->MActor->GetDynamicMaterials())
+	for (auto& OccludedActor : OccludedActors)
 	{
-		for (const auto DynamicMaterial : DynamicMaterialArrayWrapper.ArrayMaterialInstanceDynamic)
+		if (!OccludedActor.MActor.IsValid())
 		{
-			if (DynamicMaterial)
-			{
-				float CurrentOpacity;
-				const auto bParamExist = DynamicMaterial->GetScalarParameterValue(FName("OccludedOpacity"), CurrentOpacity);
-				if (!bParamExist)
-					continue;
-
-				bAtLeastOneParamHasOpacity = true;
+			OccludedActor.PendingKill = true;
+			continue;
+		}
+		if (OccludedActor.PendingKill)
+			continue;
+		if (OccludedActor.TransitionRemainTime <= 0.f)
+		{
+			// Finished show transition, e.g. the one that was switched right after the hide started
+			OccludedActor.PendingKill = OccludedActor.TargetOpacity == 1.f;
+			continue;
+		}
 
-				const auto InitialOpacity = OccludedActor->TargetOpacity == 1.f ? OccludedOpacity : 1.f;
-				const float NewOpacity = FMath::Lerp(InitialOpacity, OccludedActor->TargetOpacity,
-					1.f - OccludedActor->TransitionRemainTime / OpacityTransitionDuration);
+		OccludedActor.TransitionRemainTime = FMath::Clamp(OccludedActor.TransitionRemainTime - DeltaTime, 0.f, OpacityTransitionDuration);
 
-				DynamicMaterial->SetScalarParameterValue("OccludedOpacity", NewOpacity);
+		// Calculate New Opacity
+		const auto InitialOpacity = OccludedActor.TargetOpacity == 1.f ? OccludedOpacity : 1.f;
+		const float NewOpacity = FMath::Lerp(InitialOpacity, OccludedActor.TargetOpacity,
+			1.f - OccludedActor.TransitionRemainTime / OpacityTransitionDuration);
 
-				// Finished transition
-				if (OccludedActor->TransitionRemainTime <= 0.f)
-				{
-					OccludedActor->TransitionRemainTime = 0.f;
-					GetWorld()->GetTimerManager().ClearTimer(OccludedActor->OpacityTimerHandle);
+		for (const auto DynamicMaterial : OccludedActor.FadedMaterials)
+		{
+			DynamicMaterial->SetScalarParameterValue(OccludedOpacityName, NewOpacity);
+		}
 
-					if (OccludedActor->TargetOpacity == 1.f)
-					{
-						OccludedActor->PendingKill = true; // Finished show transition. Finally can be removed.
-					}
-				}
-			}
+		// Finished show transition. Finally can be removed.
+		if (OccludedActor.TransitionRemainTime <= 0.f && OccludedActor.TargetOpacity == 1.f)
+		{
+			OccludedActor.PendingKill = true;
 		}
 	}
 
-	if (!bAtLeastOneParamHasOpacity)
+	// Swap removal keeps the array dense without shifting, the order doesn't matter
+	for (int32 i = OccludedActors.Num() - 1; i >= 0; --i)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(OccludedActor->OpacityTimerHandle);
+		if (OccludedActors[i].PendingKill)
+		{
+			if (const auto MActor = OccludedActors[i].MActor.Get())
+			{
+				// Fully opaque again, so the actor can be batched with the others
+				MActor->RestoreSharedMaterials();
+				// Collapse it back into the instances if it was promoted for the fade
+				if (const auto GroundBlock = Cast<AMGroundBlock>(MActor->GetAttachParentActor()))
+				{
+					GroundBlock->DemoteActor(MActor);
+				}
+			}
+			OccludedActors.RemoveAtSwap(i, 1, false);
+		}
 	}
 }
 
-void AMPlayerController::HideOccludedActor(const AMActor* MActor, float Distance)
+void AMPlayerController::HideOccludedActor(AMActor* MActor, float Distance)
 {
-	const auto FoundResult = OccludedActors.Find(FName(MActor->GetName()));
-	if (!FoundResult || !*FoundResult || !(*FoundResult)->MActor) // the ordinary case. Just marked to be hidden, initiate the transition 
+	auto* FoundResult = OccludedActors.FindByPredicate([MActor](const FCameraOccludedActor& OccludedActor)
+	{
+		return OccludedActor.MActor == MActor && !OccludedActor.PendingKill;
+	});
+	if (!FoundResult) // the ordinary case. Just marked to be hidden, initiate the transition
 	{
-		UCameraOccludedActor* OccludedActor = NewObject<UCameraOccludedActor>(this);
-		OccludedActor->Name = FName(MActor->GetName());
-		OccludedActor->MActor = MActor;
-		OccludedActor->Distance = Distance;
-		OccludedActors.Add(FName(MActor->GetName()), OccludedActor);
+		auto& OccludedActor = OccludedActors.AddDefaulted_GetRef();
+		OccludedActor.MActor = MActor;
+		OccludedActor.Distance = Distance;
+		OccludedActor.bOccluding = true;
 		OnHideOccludedActor(OccludedActor);
 	}
 	else
 	{
-		if (!FMath::IsNearlyEqual((*FoundResult)->TargetOpacity, OccludedOpacity)) // Hide only if has been appearing to switch the transition
+		FoundResult->bOccluding = true;
+		if (!FMath::IsNearlyEqual(FoundResult->TargetOpacity, OccludedOpacity)) // Hide only if has been appearing to switch the transition
 		{
 			OnHideOccludedActor(*FoundResult);
 		}
 	}
 }
 
-void AMPlayerController::ShowOccludedActor(UCameraOccludedActor* OccludedActor)
+void AMPlayerController::ShowOccludedActor(FCameraOccludedActor& OccludedActor)
 {
-	if (!OccludedActor->MActor)
+	if (!OccludedActor.MActor.IsValid())
 	{
 		return;
 	}
@@ -523,26 +591,58 @@ void AMPlayerController::ShowOccludedActor(UCameraOccludedActor* OccludedActor)
 	OnShowOccludedActor(OccludedActor);
 }
 
-void AMPlayerController::OnShowOccludedActor(UCameraOccludedActor* OccludedActor)
+void AMPlayerController::SetActorOccludedForDebug(AMActor* MActor, bool bOccluded)
 {
-	OccludedActor->TargetOpacity = 1.f;
-	OccludedActor->LastUpdateTime = GetWorld()->GetTimeSeconds();
-	OccludedActor->TransitionRemainTime = FMath::Max(0.f, OpacityTransitionDuration - OccludedActor->TransitionRemainTime);
+	if (bOccluded)
+	{
+		HideOccludedActor(MActor, 0.f);
+		return;
+	}
+
+	if (const auto OccludedActor = OccludedActors.FindByPredicate([MActor](const FCameraOccludedActor& Candidate) { return Candidate.MActor.Get() == MActor; }))
+	{
+		OccludedActor->bOccluding = false;
+		ShowOccludedActor(*OccludedActor);
+	}
+}
+
+void AMPlayerController::OnShowOccludedActor(FCameraOccludedActor& OccludedActor)
+{
+	OccludedActor.TargetOpacity = 1.f;
+	OccludedActor.TransitionRemainTime = FMath::Max(0.f, OpacityTransitionDuration - OccludedActor.TransitionRemainTime);
 
-	GetWorld()->GetTimerManager().ClearTimer(OccludedActor->OpacityTimerHandle);
-	GetWorld()->GetTimerManager().SetTimer(OccludedActor->OpacityTimerHandle, [this, OccludedActor]() {
-		UpdateOpacity(OccludedActor);
-	}, 0.02f, true);
+	if (OccludedActor.FadedMaterials.IsEmpty() || OccludedActor.TransitionRemainTime <= 0.f)
+	{
+		OccludedActor.PendingKill = true; // Nothing to fade, don't keep the record
+	}
 }
 
-void AMPlayerController::OnHideOccludedActor(UCameraOccludedActor* OccludedActor)
+void AMPlayerController::OnHideOccludedActor(FCameraOccludedActor& OccludedActor)
 {
-	OccludedActor->TargetOpacity = OccludedOpacity;
-	OccludedActor->LastUpdateTime = GetWorld()->GetTimeSeconds();
-	OccludedActor->TransitionRemainTime = FMath::Max(0.f, OpacityTransitionDuration - OccludedActor->TransitionRemainTime);
+	OccludedActor.TargetOpacity = OccludedOpacity;
+	OccludedActor.TransitionRemainTime = FMath::Max(0.f, OpacityTransitionDuration - OccludedActor.TransitionRemainTime);
 
-	GetWorld()->GetTimerManager().ClearTimer(OccludedActor->OpacityTimerHandle);
-	GetWorld()->GetTimerManager().SetTimer(OccludedActor->OpacityTimerHandle, [this, OccludedActor]() {
-		UpdateOpacity(OccludedActor);
-	}, 0.02f, true);
+	if (!OccludedActor.FadedMaterials.IsEmpty())
+		return;
+
+	// The parameter lookup is done once per fade, not per material per frame
+	const auto MActor = OccludedActor.MActor.Get();
+	MActor->CreateDynamicMaterials();
+	for (const auto& [StaticMesh, DynamicMaterialArrayWrapper] : MActor->GetDynamicMaterials())
+	{
+		for (const auto DynamicMaterial : DynamicMaterialArrayWrapper.ArrayMaterialInstanceDynamic)
+		{
+			float CurrentOpacity;
+			if (DynamicMaterial && DynamicMaterial->GetScalarParameterValue(FName("OccludedOpacity"), CurrentOpacity))
+			{
+				OccludedActor.FadedMaterials.Add(DynamicMaterial);
+			}
+		}
+	}
+
+	// If object doesn't support opacity, there is no reason to keep its materials dynamic
+	if (OccludedActor.FadedMaterials.IsEmpty())
+	{
+		MActor->RestoreSharedMaterials();
+	}
 }
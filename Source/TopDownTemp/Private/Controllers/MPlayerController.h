@@ -24,22 +24,24 @@ enum class EFloatingNumberType : uint8
 	Healing
 };
 
-UCLASS()
-class UCameraOccludedActor : public UObject
+/** Fade state of an actor occluding the camera. Plain data, all the fades are advanced together by the controller */
+USTRUCT()
+struct FCameraOccludedActor
 {
 	GENERATED_BODY()
 
-public:
-	FName Name;
+	UPROPERTY()
+	TWeakObjectPtr<AMActor> MActor;
+
+	/** Dynamic materials of the actor that have the opacity parameter. Owned by the actor */
+	TArray<UMaterialInstanceDynamic*, TInlineAllocator<8>> FadedMaterials;
 
 	float TargetOpacity = 1.f;
 	float TransitionRemainTime = 0.f;
-	float LastUpdateTime = 0.f;
 	float Distance = 0;
-	FTimerHandle OpacityTimerHandle;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	const AMActor* MActor = nullptr;
+	/** Hit by the latest occlusion trace */
+	bool bOccluding = false;
 
 	bool PendingKill = false;
 };
@@ -87,9 +89,6 @@ protected: // Occlusion
 	UPROPERTY(EditDefaultsOnly, Category="Camera Occlusion|Occlusion")
 	float OpacityTransitionDuration = 0.7f;
 
-	/** Autonomously updates opacity smoothly for the rest of duration */
-	void UpdateOpacity(UCameraOccludedActor* OccludedActor);
-
 	/** How much of the Pawn capsule Radius and Height
 	 * should be used for the Line Trace before considering an Actor occluded?
 	 * Values too low may make the camera clip through walls.
@@ -118,13 +117,20 @@ protected: // Occlusion
 	bool DebugLineTraces = false;
 
 private:
+	/** Dense and small, so a linear search by pointer is cheaper than hashing names */
 	UPROPERTY()
-	TMap<FName, UCameraOccludedActor*> OccludedActors;
+	TArray<FCameraOccludedActor> OccludedActors;
+
+	/** Reused by every occlusion trace */
+	TArray<FHitResult> OcclusionHits;
 
-	void HideOccludedActor(const AMActor* MActor, float Distance);
-	void OnHideOccludedActor(UCameraOccludedActor* OccludedActor);
-	void ShowOccludedActor(UCameraOccludedActor* OccludedActor);
-	void OnShowOccludedActor(UCameraOccludedActor* OccludedActor);
+	void HideOccludedActor(AMActor* MActor, float Distance);
+	void OnHideOccludedActor(FCameraOccludedActor& OccludedActor);
+	void ShowOccludedActor(FCameraOccludedActor& OccludedActor);
+	void OnShowOccludedActor(FCameraOccludedActor& OccludedActor);
+
+	/** Advances the transitions of all the occluded actors at once */
+	void UpdateOpacity(float DeltaTime);
 
 	__forceinline bool ShouldCheckCameraOcclusion() const
 	{
@@ -144,6 +150,15 @@ public:
 	UPROPERTY()
 	uint8 ObserverIndex = -1;
 
+public: // For debugging
+	int GetOccludedActorsNumber() const { return OccludedActors.Num(); }
+
+	/** Fades the actor out or back in as if the camera trace found or lost it, so the fades can be benchmarked without tracing */
+	void SetActorOccludedForDebug(AMActor* MActor, bool bOccluded);
+
+	/** Advances the fades by the given time, as the controller tick does */
+	void UpdateOpacityForDebug(float DeltaTime) { UpdateOpacity(DeltaTime); }
+
 protected: // Other
 	virtual void BeginPlay() override;
 
@@ -164,6 +179,20 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	TSubclassOf<AMCharacter> ToSpawnPlayerClass;
 
+	/** Collapsed decorative actors closer to the pawn are promoted on the server, so they can be harvested and their inventories accessed.\n
+	 * They are demoted back once no pawn is within the radius, unless gameplay has kept them meanwhile */
+	UPROPERTY(EditDefaultsOnly)
+	float GameplayPromotionRadius = 500.f;
+
+	FTimerHandle GameplayPromotionTimerHandle;
+
+	/** Server only */
+	void PromoteInstancesAroundPawn();
+
+	bool IsAnyPawnNearby(const FVector& Location) const;
+
+	TSet<TWeakObjectPtr<AMActor>> ProximityPromotedActors;
+
 	// Begin PlayerController interface
 	virtual void PlayerTick(float DeltaTime) override;
 	virtual void SetupInputComponent() override;
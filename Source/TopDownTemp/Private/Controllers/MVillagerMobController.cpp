@@ -3,7 +3,8 @@
 #include "Components/MIsActiveCheckerComponent.h"
 #include "Characters/MMemoryator.h"
 #include "Blueprint/AIBlueprintHelperLibrary.h"
-#include "Managers/MWorldGenerator.h"
+#include "Managers/MNavPointPoolSubsystem.h"
+#include "Managers/MPerceptionSubsystem.h"
 #include "NavigationSystem.h"
 #include "Components/MStateModelComponent.h"
 #include "Components/MStatsModelComponent.h"
@@ -19,39 +20,42 @@ AMVillagerMobController::AMVillagerMobController(const FObjectInitializer& Objec
 
 void AMVillagerMobController::PreTick(float DeltaSeconds, const UWorld& World, AMCharacter& MyCharacter)
 {
-	if (const auto WorldGenerator = AMGameMode::GetWorldGenerator(this))
+	const auto PerceptionSubsystem = World.GetSubsystem<UMPerceptionSubsystem>();
+	if (!PerceptionSubsystem)
 	{
-		const auto MyLocation = MyCharacter.GetTransform().GetLocation();
-		const auto ForgetEnemyRange = MyCharacter.GetStatsModelComponent()->GetForgetEnemyRange();
-		const auto DynamicActorsNearby = WorldGenerator->GetActorsInRect(MyLocation - FVector(ForgetEnemyRange,ForgetEnemyRange, 0.f), MyLocation + FVector(ForgetEnemyRange,ForgetEnemyRange, 0.f), true);
-		EnemiesNearby.Empty();
+		check(false);
+		return;
+	}
+
+	EnemiesNearby.Empty();
+
+	const auto ForgetEnemyRange = MyCharacter.GetStatsModelComponent()->GetForgetEnemyRange();
+	const auto SightRange = MyCharacter.GetStatsModelComponent()->GetSightRange();
+	for (const auto& Perceived : PerceptionSubsystem->GetPerceived(&MyCharacter))
+	{
+		// The closest go first, the rest are too far to care about
+		if (Perceived.Distance > ForgetEnemyRange)
+			break;
+
+		const auto Character = Perceived.Character.Get();
+		if (!Character)
+			continue;
 
-		if (!DynamicActorsNearby.IsEmpty())
+		// Split characters by role
+
+		// Check if the character is an enemy
+		if (Perceived.Attitude == ETeamAttitude::Type::Hostile)
 		{
-			for (const auto& [Name, DynamicActor] : DynamicActorsNearby)
+			EnemiesNearby.Add(FName(Character->GetName()), Character);
+			// Run if we see an enemy. There is no need to run away if we're already hiding
+			if (Perceived.Distance <= SightRange && CurrentBehavior != EMobBehaviors::Hide && CurrentBehavior != EMobBehaviors::Retreat)
 			{
-				// The actors are taken in a square area, in the corners the distance is greater than the radius
-				const auto DistanceToActor = FVector::Distance(DynamicActor->GetTransform().GetLocation(), MyCharacter.GetTransform().GetLocation());
-				if (DistanceToActor <= MyCharacter.GetStatsModelComponent()->GetForgetEnemyRange())
-				{
-					// Split dynamic actors by role
-
-					// Check if the actor is an enemy
-					if (FGenericTeamId::GetAttitude(&MyCharacter, DynamicActor) == ETeamAttitude::Type::Hostile)
-					{
-						EnemiesNearby.Add(Name, DynamicActor);
-						// Run if we see an enemy. There is no need to run away if we're already hiding
-						if (DistanceToActor <= MyCharacter.GetStatsModelComponent()->GetSightRange() && CurrentBehavior != EMobBehaviors::Hide && CurrentBehavior != EMobBehaviors::Retreat)
-						{
-							SetRetreatBehavior(World, MyCharacter);
-							break;
-						}
-					}
-				
-					//TODO: Check if the actor is a friend
-				}
+				SetRetreatBehavior(World, MyCharacter);
+				break;
 			}
 		}
+
+		//TODO: Check if the actor is a friend
 	}
 }
 
@@ -74,6 +78,16 @@ void AMVillagerMobController::DoIdleBehavior(const UWorld& World, AMCharacter& M
 				return;
 			const auto Village = MyCharacter.GetHouse()->GetOwnerOutpost();
 			if (!Village) { check(false); return; }
+			// Most of the time the pool has a point ready, so nothing is projected here
+			if (const auto NavPointPool = World.GetSubsystem<UMNavPointPoolSubsystem>())
+			{
+				if (FVector PooledPoint; NavPointPool->DrawPoint(Village, PooledPoint))
+				{
+					SetWalkBehavior(World, MyCharacter, PooledPoint);
+					return;
+				}
+			}
+
 			const auto VillageCenter = Village->GetActorLocation();
 
 			constexpr int TriesToFindLocation = 3;
@@ -164,7 +178,7 @@ void AMVillagerMobController::SetWalkBehavior(const UWorld& World, AMCharacter&
 
 		SetIdleBehavior(&World, &MyCharacter);
 	});
-	MoveToLocation(DestinationPoint);
+	RequestMoveToLocation(DestinationPoint);
 
 	OnBehaviorChanged(MyCharacter);
 }
@@ -206,7 +220,7 @@ void AMVillagerMobController::SetRetreatBehavior(const UWorld& World, AMCharacte
 			FVector MyCharacterOrigin, MyCharacterBoxExtent;
 			MyCharacter.GetActorBounds(true, MyCharacterOrigin, MyCharacterBoxExtent, true);
 			//MoveToLocation(EntryPointComponent->GetComponentLocation(), /*MyCharacterBoxExtent.Size2D()*/ 20.f); //TODO: remove this workaround
-			MoveToLocation(EntryPoint, /*MyCharacterBoxExtent.Size2D()*/ 20.f); //TODO: remove this workaround
+			RequestMoveToLocation(EntryPoint, /*MyCharacterBoxExtent.Size2D()*/ 20.f); //TODO: remove this workaround
 		}
 
 		OnBehaviorChanged(MyCharacter);
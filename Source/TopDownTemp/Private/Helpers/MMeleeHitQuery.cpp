@@ -0,0 +1,93 @@
+#include "MMeleeHitQuery.h"
+
+#include "Characters/MCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Managers/MWorldGenerator.h"
+
+namespace
+{
+	/** Characters are registered in blocks by their centers, so a big capsule may reach the sector from outside of its rect */
+	constexpr float MaxTargetRadius = 200.f;
+}
+
+void FMMeleeTargets::Add(AActor* Actor, const FVector& Location, float IN_Radius)
+{
+	Actors.Add(Actor);
+	X.Add(Location.X);
+	Y.Add(Location.Y);
+	Radius.Add(IN_Radius);
+}
+
+void FMMeleeTargets::Reset()
+{
+	Actors.Reset();
+	X.Reset();
+	Y.Reset();
+	Radius.Reset();
+}
+
+void MMeleeHitQuery::TestSector(const FMMeleeSector& Sector, const FMMeleeTargets& Targets, TArray<uint8>& OutHits)
+{
+	const int32 Num = Targets.Num();
+	OutHits.SetNumUninitialized(Num);
+	if (Num == 0)
+		return;
+
+	// The only trigonometry, done once per sector
+	float SinHalfAngle, CosHalfAngle;
+	FMath::SinCos(&SinHalfAngle, &CosHalfAngle, FMath::DegreesToRadians(FMath::Clamp(Sector.Angle, 0.f, 360.f) / 2.f));
+
+	const float OriginX = Sector.Origin.X;
+	const float OriginY = Sector.Origin.Y;
+	const float DirectionX = Sector.Direction.X;
+	const float DirectionY = Sector.Direction.Y;
+	const float Length = Sector.Length;
+
+	const float* RESTRICT X = Targets.X.GetData();
+	const float* RESTRICT Y = Targets.Y.GetData();
+	const float* RESTRICT Radius = Targets.Radius.GetData();
+	uint8* RESTRICT Hits = OutHits.GetData();
+
+	// No branches in the loop, so the compiler is free to vectorize it
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const float DeltaX = X[i] - OriginX;
+		const float DeltaY = Y[i] - OriginY;
+		const float Distance = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY);
+		const float SafeDistance = FMath::Max(Distance, UE_KINDA_SMALL_NUMBER);
+
+		// The circle is seen from the origin at +-W, where W = 2 * asin(R / 2D). Same as the intersection points IsCircleWithin finds.
+		// Compare cosines instead of angles: cos(Offset) >= cos(HalfAngle + W)
+		const float S = FMath::Min(Radius[i] * 0.5f / SafeDistance, 1.f);
+		const float CosW = 1.f - 2.f * S * S;
+		const float SinW = 2.f * S * FMath::Sqrt(FMath::Max(1.f - S * S, 0.f));
+		const float CosOffset = (DeltaX * DirectionX + DeltaY * DirectionY) / SafeDistance;
+
+		const bool bWithinLength = Distance - Radius[i] <= Length;
+		const bool bCoversEverything = CosW <= -CosHalfAngle; // HalfAngle + W >= 180
+		const bool bWithinSpread = CosOffset >= CosHalfAngle * CosW - SinHalfAngle * SinW;
+		Hits[i] = static_cast<uint8>(bWithinLength & (bCoversEverything | bWithinSpread));
+	}
+}
+
+void MMeleeHitQuery::GatherTargets(AMWorldGenerator& WorldGenerator, const FMMeleeSector& Sector, const AActor* IgnoredActor, FMMeleeTargets& OutTargets)
+{
+	OutTargets.Reset();
+
+	const float Extent = Sector.Length + MaxTargetRadius;
+	const FVector Origin(Sector.Origin, 0.f);
+	for (const auto& [Name, Actor] : WorldGenerator.GetActorsInRect(Origin - FVector(Extent, Extent, 0.f), Origin + FVector(Extent, Extent, 0.f), true))
+	{
+		if (!IsValid(Actor) || Actor == IgnoredActor || !Actor->IsA<AMCharacter>())
+			continue;
+
+		// Pawns whose collision can be queried, the same as the object query the puddle did
+		const auto CapsuleComponent = Cast<UCapsuleComponent>(Actor->GetRootComponent());
+		if (CapsuleComponent &&
+			CapsuleComponent->GetCollisionObjectType() == ECC_Pawn &&
+			CapsuleComponent->IsQueryCollisionEnabled())
+		{
+			OutTargets.Add(Actor, Actor->GetActorLocation(), CapsuleComponent->GetScaledCapsuleRadius());
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class AMWorldGenerator;
+
+/** Melee attack zone on the ground plane. Symmetric around Direction */
+struct FMMeleeSector
+{
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/** Unit vector to the middle of the sector */
+	FVector2D Direction = FVector2D(1.f, 0.f);
+
+	float Length = 0.f;
+
+	/** Full spread in degrees, between 0 and 360 */
+	float Angle = 0.f;
+};
+
+/** Hit candidates. Kept as separate arrays of floats so the sector test runs as one branchless loop over them */
+struct FMMeleeTargets
+{
+	TArray<AActor*> Actors;
+
+	TArray<float> X;
+
+	TArray<float> Y;
+
+	TArray<float> Radius;
+
+	void Add(AActor* Actor, const FVector& Location, float IN_Radius);
+
+	void Reset();
+
+	int32 Num() const { return Actors.Num(); }
+};
+
+/** Resolves which targets a melee attack hits.\n
+ * Each target is a circle (capsule seen from above). It's hit if it's within the sector's length and its angular
+ * width overlaps the spread, same as UMAttackPuddleComponent::IsCircleWithin, but without any trigonometry per target. */
+namespace MMeleeHitQuery
+{
+	/** Fills OutHits with 1 for every target touching the sector and 0 otherwise */
+	TOPDOWNTEMP_API void TestSector(const FMMeleeSector& Sector, const FMMeleeTargets& Targets, TArray<uint8>& OutHits);
+
+	/** Collects the dynamic actors with a Pawn capsule around the sector, using the world generator's grid of blocks.\n
+	 * Only capsules of the Pawn object type with query collision enabled count, as in the puddle's object query */
+	TOPDOWNTEMP_API void GatherTargets(AMWorldGenerator& WorldGenerator, const FMMeleeSector& Sector, const AActor* IgnoredActor, FMMeleeTargets& OutTargets);
+}
@@ -0,0 +1,104 @@
+#include "MPCGRoadExclusion.h"
+
+#include "PCGComponent.h"
+#include "PCGContext.h"
+#include "Data/PCGPointData.h"
+#include "StationaryActors/MGroundBlock.h"
+
+#define LOCTEXT_NAMESPACE "PCGRoadExclusionSettings"
+
+namespace PCGRoadExclusionSettings
+{
+	static const FName KeptPointsLabel = TEXT("KeptPoints");
+	static const FName ExcludedPointsLabel = TEXT("ExcludedPoints");
+}
+
+TArray<FPCGPinProperties> UMPCGRoadExclusionSettings::OutputPinProperties() const
+{
+	TArray<FPCGPinProperties> Properties;
+
+	Properties.Emplace(PCGRoadExclusionSettings::KeptPointsLabel, EPCGDataType::Point);
+	Properties.Emplace(PCGRoadExclusionSettings::ExcludedPointsLabel, EPCGDataType::Point);
+
+	return Properties;
+}
+
+FPCGElementPtr UMPCGRoadExclusionSettings::CreateElement() const
+{
+	return MakeShared<FPCGRoadExclusionElement>();
+}
+
+bool FPCGRoadExclusionElement::ExecuteInternal(FPCGContext* Context) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FPCGRoadExclusionElement::Execute);
+
+	check(Context);
+
+	const UMPCGRoadExclusionSettings* Settings = Context->GetInputSettings<UMPCGRoadExclusionSettings>();
+	check(Settings);
+
+	TArray<FPCGTaggedData>& Outputs = Context->OutputData.TaggedData;
+
+	// The ground block owning the PCG component knows which roads cross it
+	const AMGroundBlock* GroundBlock = Context->SourceComponent.IsValid() ? Cast<AMGroundBlock>(Context->SourceComponent->GetOwner()) : nullptr;
+	if (!GroundBlock)
+	{
+		PCGE_LOG(Warning, GraphAndLog, LOCTEXT("NoGroundBlock", "The graph is not executed by a ground block, no points are excluded"));
+	}
+	const TArray<FRoadCorridor> EmptyCorridors;
+	const TArray<FRoadCorridor>& Corridors = GroundBlock ? GroundBlock->PCGVariables.RoadCorridors : EmptyCorridors;
+
+	for (const FPCGTaggedData& Input : Context->InputData.GetInputsByPin(PCGPinConstants::DefaultInputLabel))
+	{
+		const UPCGPointData* PointData = Cast<UPCGPointData>(Input.Data);
+
+		if (!PointData)
+		{
+			PCGE_LOG(Error, GraphAndLog, LOCTEXT("InputNotPointData", "Input is not a point data"));
+			continue;
+		}
+
+		const TArray<FPCGPoint>& InPoints = PointData->GetPoints();
+
+		// Create output point data
+		UPCGPointData* KeptPointsData = NewObject<UPCGPointData>();
+		KeptPointsData->InitializeFromData(PointData);
+		TArray<FPCGPoint>& KeptPoints = KeptPointsData->GetMutablePoints();
+		KeptPoints.Reserve(InPoints.Num());
+
+		UPCGPointData* ExcludedPointsData = NewObject<UPCGPointData>();
+		ExcludedPointsData->InitializeFromData(PointData);
+		TArray<FPCGPoint>& ExcludedPoints = ExcludedPointsData->GetMutablePoints();
+
+		for (const FPCGPoint& Point : InPoints)
+		{
+			const FVector2D Location(Point.Transform.GetLocation());
+			const bool bOnRoad = Corridors.ContainsByPredicate([&Location, Settings](const FRoadCorridor& Corridor)
+			{
+				return Corridor.IsPointWithin(Location, Settings->Margin);
+			});
+
+			if (bOnRoad)
+			{
+				ExcludedPoints.Add(Point);
+			}
+			else
+			{
+				KeptPoints.Add(Point);
+			}
+		}
+
+		// Output all in output collection
+		FPCGTaggedData& KeptTaggedData = Outputs.Add_GetRef(Input);
+		KeptTaggedData.Data = KeptPointsData;
+		KeptTaggedData.Pin = PCGRoadExclusionSettings::KeptPointsLabel;
+
+		FPCGTaggedData& ExcludedTaggedData = Outputs.Add_GetRef(Input);
+		ExcludedTaggedData.Data = ExcludedPointsData;
+		ExcludedTaggedData.Pin = PCGRoadExclusionSettings::ExcludedPointsLabel;
+	}
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
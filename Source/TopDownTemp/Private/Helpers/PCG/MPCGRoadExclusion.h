@@ -0,0 +1,38 @@
+#pragma once
+
+#include "PCGSettings.h"
+#include "PCGPin.h"
+
+#include "MPCGRoadExclusion.generated.h"
+
+/** Removes points lying on the roads crossing the ground block. Corridors are taken from AMGroundBlock::PCGVariables */
+UCLASS(BlueprintType)
+class UMPCGRoadExclusionSettings : public UPCGSettings
+{
+	GENERATED_BODY()
+public:
+	//~Begin UPCGSettings interface
+#if WITH_EDITOR
+	virtual FName GetDefaultNodeName() const override { return FName(TEXT("NativeRoadExclusion")); }
+	virtual FText GetDefaultNodeTitle() const override { return NSLOCTEXT("PCGRoadExclusionSettings", "NodeTitle", "Native Road Exclusion"); }
+	virtual FText GetNodeTooltipText() const override { return NSLOCTEXT("PCGRoadExclusionSettings", "NodeTooltip", "Split a point input in 2, depending on whether points are on the block's roads."); }
+	virtual EPCGSettingsType GetType() const override { return EPCGSettingsType::Filter; }
+#endif
+
+protected:
+	virtual TArray<FPCGPinProperties> InputPinProperties() const override { return Super::DefaultPointInputPinProperties(); }
+	virtual TArray<FPCGPinProperties> OutputPinProperties() const override;
+	virtual FPCGElementPtr CreateElement() const override;
+	//~End UPCGSettings interface
+
+public:
+	/** Extra distance kept from the road, on top of the road corridor width. Useful for large meshes. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Settings", meta = (PCG_Overridable, ClampMin = 0.0))
+	float Margin = 0.f;
+};
+
+class FPCGRoadExclusionElement : public IPCGElement
+{
+protected:
+	virtual bool ExecuteInternal(FPCGContext* Context) const override;
+};
@@ -2,13 +2,19 @@
 
 #include "MBlockGenerator.h"
 
+#include "MGridAddressing.h"
 #include "MMetadataManager.h"
 #include "MWorldGenerator.h"
+#include "RoadManager/MRoadManager.h"
 #include "PCGComponent.h"
 #include "StationaryActors/MGroundBlock.h"
 #include "PCGGraph.h"
+#include "PCGNode.h"
+#include "Helpers/PCG/MPCGRoadExclusion.h"
 #include "Framework/MGameMode.h"
 #include "StationaryActors/MActor.h"
+#include "TopDownTemp.h"
+#include "UObject/ObjectKey.h"
 
 void UMBlockGenerator::SpawnActorsRandomly(const FIntPoint BlockIndex, AMWorldGenerator* pWorldGenerator, UBlockMetadata* BlockMetadata, const FName& PresetName)
 {
@@ -18,6 +24,13 @@ void UMBlockGenerator::SpawnActorsRandomly(const FIntPoint BlockIndex, AMWorldGe
 		return;
 	}
 
+	// Roads go first, so the block content is spawned once and never overlaps them
+	const auto RoadManager = AMGameMode::GetRoadManager(this);
+	if (RoadManager)
+	{
+		RoadManager->PrepareRoadsForBlock(BlockIndex);
+	}
+
 	FActorSpawnParameters BlockSpawnParameters;
 	BlockSpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
@@ -25,8 +38,14 @@ void UMBlockGenerator::SpawnActorsRandomly(const FIntPoint BlockIndex, AMWorldGe
 	{
 		if (const auto PCGComponent = Cast<UPCGComponent>(GroundBlock->GetComponentByClass(UPCGComponent::StaticClass())))
 		{
-			SetPCGVariablesByPreset(GroundBlock, PresetName, BlockMetadata->Biome, BlockMetadata->PCGGraph);
+			SetPCGVariablesByPreset(GroundBlock, BlockIndex, PresetName, BlockMetadata->Biome, BlockMetadata->PCGGraph);
+			if (RoadManager)
+			{
+				GroundBlock->PCGVariables.RoadCorridors = RoadManager->GetRoadCorridors(BlockIndex);
+				WarnIfRoadsAreNotExcluded(BlockMetadata->PCGGraph, GroundBlock->PCGVariables.RoadCorridors);
+			}
 			PCGComponent->SetGraph(BlockMetadata->PCGGraph);
+			PCGComponent->Seed = GroundBlock->PCGVariables.Seed;
 			PCGComponent->Generate(false);
 		}
 		GroundBlock->UpdateBiome(BlockMetadata->Biome);
@@ -35,6 +54,34 @@ void UMBlockGenerator::SpawnActorsRandomly(const FIntPoint BlockIndex, AMWorldGe
 	}
 }
 
+void UMBlockGenerator::WarnIfRoadsAreNotExcluded(const UPCGGraphInterface* GraphInterface, const TArray<FRoadCorridor>& RoadCorridors)
+{
+	const auto Graph = GraphInterface ? GraphInterface->GetGraph() : nullptr;
+	if (!Graph || RoadCorridors.IsEmpty())
+		return;
+
+	// Once per graph, the set of graphs is tiny
+	static TSet<TObjectKey<UPCGGraph>> CheckedGraphs;
+	bool bAlreadyChecked = false;
+	CheckedGraphs.Add(Graph, &bAlreadyChecked);
+	if (bAlreadyChecked)
+		return;
+
+	if (!HasRoadExclusion(Graph))
+	{
+		UE_LOG(LogTopDownTemp, Warning, TEXT("PCG graph %s has no Native Road Exclusion node, its content will overlap roads"), *Graph->GetName());
+	}
+}
+
+bool UMBlockGenerator::HasRoadExclusion(const UPCGGraphInterface* GraphInterface)
+{
+	const auto Graph = GraphInterface ? GraphInterface->GetGraph() : nullptr;
+	return Graph && Graph->GetNodes().ContainsByPredicate([](const UPCGNode* Node)
+	{
+		return Node && Node->GetSettings() && Node->GetSettings()->IsA<UMPCGRoadExclusionSettings>();
+	});
+}
+
 void UMBlockGenerator::SpawnActorsSpecifically(const FIntPoint BlockIndex, AMWorldGenerator* pWorldGenerator, const FBlockSaveData* BlockSD)
 {
 	if (!IsValid(pWorldGenerator) || !GroundBlockBPClass)
@@ -52,20 +99,24 @@ void UMBlockGenerator::SpawnActorsSpecifically(const FIntPoint BlockIndex, AMWor
 		{
 			GroundBlock->PCGVariables = BlockSD->PCGVariables;
 			PCGComponent->SetGraph(BlockSD->PCGVariables.Graph.Get());
+			PCGComponent->Seed = BlockSD->PCGVariables.Seed;
 			PCGComponent->Generate(false);
 		}
 		GroundBlock->UpdateBiome(BlockSD->PCGVariables.Biome);
 		// If you add any additional logic, make sure to duplicate it for AMGroundBlock::OnPCGVariablesReplicated
-		AMGameMode::GetMetadataManager(this)->FindBlock(BlockIndex)->pGroundBlock = GroundBlock;
+		const auto BlockMetadata = AMGameMode::GetMetadataManager(this)->FindBlock(BlockIndex);
+		BlockMetadata->pGroundBlock = GroundBlock;
 	}
 }
 
-void UMBlockGenerator::SetPCGVariablesByPreset(AMGroundBlock* BlockActor, const FName PresetName, EBiome Biome, UPCGGraphInterface* Graph)
+void UMBlockGenerator::SetPCGVariablesByPreset(AMGroundBlock* BlockActor, const FIntPoint& BlockIndex, const FName PresetName, EBiome Biome, UPCGGraphInterface* Graph)
 {
 	if (BlockActor) 
 	{
 		BlockActor->PCGVariables.Graph = Graph;
 		BlockActor->PCGVariables.Biome = Biome;
+		// The same block always gets the same seed, whoever and whenever generates it
+		BlockActor->PCGVariables.Seed = static_cast<int32>(MGridAddressing::HashKey(BlockIndex));
 
 		FPreset Preset;
 		const auto pPreset = PresetMap.Find(PresetName);
@@ -12,6 +12,7 @@ class AMActor;
 class UPCGGraph;
 class UBlockMetadata;
 class UPCGGraphInterface;
+struct FRoadCorridor;
 enum class EBiome : uint8;
 
 /** Describes all the data can be configured for a one kind of objects in this block (trees/flowers/mushrooms/etc.) */
@@ -62,18 +63,24 @@ public:
 	 * Keep it up to date if changing SpawnActorsRandomly() */
 	void SpawnActorsSpecifically(const FIntPoint BlockIndex, AMWorldGenerator* pWorldGenerator, const FBlockSaveData* BlockSD);
 
-	/** Calculate values for PCG based on the Preset */
-	void SetPCGVariablesByPreset(AMGroundBlock* BlockActor, const FName PresetName, EBiome Biome, UPCGGraphInterface* Graph);
+	/** Calculate values for PCG based on the Preset. The seed is derived from the block index */
+	void SetPCGVariablesByPreset(AMGroundBlock* BlockActor, const FIntPoint& BlockIndex, const FName PresetName, EBiome Biome, UPCGGraphInterface* Graph);
 
 	UPCGGraph* GetDefaultGraph();
 
 	UPCGGraph* GetGraph(FName Name);
 
+	/** Whether the graph has the Native Road Exclusion node, i.e. keeps its content off the road corridors */
+	static bool HasRoadExclusion(const UPCGGraphInterface* GraphInterface);
+
 protected:
 
 	/** Returns a randomly selected preset basing on their Rarity value */
 	FPreset GetRandomPreset(EBiome Biome);
 
+	/** Road exclusion only happens if the graph has the Native Road Exclusion node. Content assets are edited separately, so say it loud when it's missing */
+	static void WarnIfRoadsAreNotExcluded(const UPCGGraphInterface* GraphInterface, const TArray<FRoadCorridor>& RoadCorridors);
+
 	//TODO: Support multiple presets
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=ContentConfig)
 	TMap<FName, FPreset> PresetMap;
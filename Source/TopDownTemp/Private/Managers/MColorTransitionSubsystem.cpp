@@ -0,0 +1,49 @@
+#include "MColorTransitionSubsystem.h"
+
+#include "Components/M2DRepresentationComponent.h"
+
+void UMColorTransitionSubsystem::StartTransition(UM2DRepresentationComponent* Representation)
+{
+	if (!Representation)
+	{
+		check(false);
+		return;
+	}
+
+	ActiveTransitions.AddUnique(Representation);
+}
+
+void UMColorTransitionSubsystem::StopTransition(UM2DRepresentationComponent* Representation)
+{
+	ActiveTransitions.RemoveSingleSwap(Representation);
+}
+
+void UMColorTransitionSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMColorTransitionSubsystem::Tick);
+
+	TransitioningSpritesNumber = 0;
+	LastTickFrame = GFrameCounter;
+
+	// Swap removal keeps the array dense without shifting, the order doesn't matter
+	for (int32 i = ActiveTransitions.Num() - 1; i >= 0; --i)
+	{
+		const auto Representation = ActiveTransitions[i];
+		if (!IsValid(Representation))
+		{
+			ActiveTransitions.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		TransitioningSpritesNumber += Representation->GetColoredSpritesNumber();
+		if (!Representation->InterpolateColor(DeltaTime))
+		{
+			ActiveTransitions.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+TStatId UMColorTransitionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMColorTransitionSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MColorTransitionSubsystem.generated.h"
+
+class UM2DRepresentationComponent;
+
+/** Animates the color of 2D representations. Only the ones in a transition are updated, nothing ticks at rest. */
+UCLASS()
+class TOPDOWNTEMP_API UMColorTransitionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** The representation is updated every frame until it reaches its desired color */
+	void StartTransition(UM2DRepresentationComponent* Representation);
+
+	void StopTransition(UM2DRepresentationComponent* Representation);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !ActiveTransitions.IsEmpty(); }
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	int32 GetActiveTransitionsNumber() const { return ActiveTransitions.Num(); }
+
+	/** Sprites recolored on the last frame. Nothing ticks without transitions, so a count older than that is stale */
+	int32 GetTransitioningSpritesNumber() const { return GFrameCounter - LastTickFrame <= 1 ? TransitioningSpritesNumber : 0; }
+
+protected:
+	UPROPERTY()
+	TArray<UM2DRepresentationComponent*> ActiveTransitions;
+
+	int32 TransitioningSpritesNumber = 0;
+
+	uint64 LastTickFrame = 0;
+};
@@ -37,7 +37,12 @@ void AMCommunicationManager::SpeakTo(AMCharacter* IN_InterlocutorCharacter)
 	}
 
 	// TODO: Refactor using only CommunicationComponent
+	if (InterlocutorCharacter)
+	{
+		RemoveConversation(InterlocutorCharacter);
+	}
 	InterlocutorCharacter = IN_InterlocutorCharacter;
+	AddConversation(InterlocutorCharacter, PlayerCharacter);
 	InterlocutorCharacter->GetCommunicationComponent()->SetInterlocutorCharacter(PlayerCharacter);
 	PlayerCharacter->GetStateModelComponent()->SetIsCommunicating(true);
 	InterlocutorCharacter->GetStateModelComponent()->SetIsCommunicating(true);
@@ -72,6 +77,7 @@ void AMCommunicationManager::StopSpeaking()
 	{
 		InterlocutorCharacter->GetCommunicationComponent()->SetInterlocutorCharacter(nullptr);
 		InterlocutorCharacter->GetStateModelComponent()->SetIsCommunicating(false);
+		RemoveConversation(InterlocutorCharacter);
 		InterlocutorCharacter = nullptr;
 	}
 
@@ -83,6 +89,64 @@ void AMCommunicationManager::StopSpeaking()
 	ReturnAllPlayerItems();
 }
 
+AMCharacter* AMCommunicationManager::GetPlayerSpeakingTo(const AMCharacter* Mob) const
+{
+	if (const auto Player = Conversations.Find(Mob))
+	{
+		return Player->Get();
+	}
+	return nullptr;
+}
+
+void AMCommunicationManager::AddConversation(const AMCharacter* Mob, AMCharacter* Player)
+{
+	if (!IsValid(Mob) || !IsValid(Player)) { check(false); return; }
+
+	// A player can't speak to two mobs at once
+	for (auto It = Conversations.CreateIterator(); It; ++It)
+	{
+		if (It->Value == Player || !It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	Conversations.Add(Mob, Player);
+}
+
+void AMCommunicationManager::RemoveConversation(const AMCharacter* Mob)
+{
+	Conversations.Remove(Mob);
+}
+
+ETeamAttitude::Type AMCommunicationManager::GetCachedAttitude(const AMCharacter* Mob, const AActor* Player)
+{
+	if (!Mob || !Player) { check(false); return ETeamAttitude::Neutral; }
+
+	const TPair<TObjectKey<AActor>, TObjectKey<AActor>> Key(Mob, Player);
+	if (const auto Attitude = AttitudeCache.Find(Key))
+	{
+		return *Attitude;
+	}
+	return AttitudeCache.Add(Key, FGenericTeamId::GetAttitude(Mob, Player));
+}
+
+void AMCommunicationManager::InvalidateAttitudes()
+{
+	AttitudeCache.Empty();
+}
+
+void AMCommunicationManager::InvalidateAttitudes(const AActor* Actor)
+{
+	const TObjectKey<AActor> ActorKey(Actor);
+	for (auto It = AttitudeCache.CreateIterator(); It; ++It)
+	{
+		if (It->Key.Key == ActorKey || It->Key.Value == ActorKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 namespace
 {
 	ETeamAttitude::Type CustomTeamAttitudeSolver(FGenericTeamId A, FGenericTeamId B)
@@ -176,13 +240,13 @@ void AMCommunicationManager::ReturnAllPlayerItems()
 			if (const auto PlayerInventory = PlayerCharacter->GetInventoryComponent())
 			{
 				// Return all the items to the player inventory. If doesn't fit, spawn as a drop
-				for (auto& ItemSlot : InventoryToOffer->GetSlots())
+				for (const auto& ItemSlot : InventoryToOffer->GetSlots())
 				{
 					if (ItemSlot.Item.Quantity <= 0)
 						continue;
 					PlayerInventory->StoreItem(ItemSlot.Item);
-					ItemSlot.Item = {0, 0};
 				}
+				InventoryToOffer->Empty();
 			}
 		}
 	}
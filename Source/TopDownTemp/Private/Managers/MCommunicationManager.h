@@ -1,6 +1,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GenericTeamAgentInterface.h"
+#include "UObject/ObjectKey.h"
 #include "MCommunicationManager.generated.h"
 
 class UMInventoryComponent;
@@ -22,6 +24,29 @@ public:
 
 	AMCharacter* GetInterlocutorCharacter() const { return InterlocutorCharacter; }
 
+	/** The player the mob is having a conversation with. Nullptr if nobody speaks to it. O(1), works for any number of players */
+	AMCharacter* GetPlayerSpeakingTo(const AMCharacter* Mob) const;
+
+	/** Registers the conversation in the registry only, without any UI or state model changes */
+	void AddConversation(const AMCharacter* Mob, AMCharacter* Player);
+
+	void RemoveConversation(const AMCharacter* Mob);
+
+	int32 GetConversationsNumber() const { return Conversations.Num(); }
+
+	/** Same as FGenericTeamId::GetAttitude(Mob, Player), but cached per mob and player.\n
+	 * Keyed by instance: CustomAttitudes can be edited per instance, and the attitude goes through the current controller */
+	ETeamAttitude::Type GetCachedAttitude(const AMCharacter* Mob, const AActor* Player);
+
+	/** Must be called whenever teams, custom attitudes or reputation change */
+	UFUNCTION(BlueprintCallable)
+	void InvalidateAttitudes();
+
+	/** Drops the cached attitudes of and towards the actor, e.g. when it's possessed by another controller */
+	void InvalidateAttitudes(const AActor* Actor);
+
+	int32 GetCachedAttitudesNumber() const { return AttitudeCache.Num(); }
+
 	UMInventoryComponent* GetInventoryToOffer() const { return InventoryToOffer; }
 
 	UMInventoryComponent* GetInventoryToReward() const { return InventoryToReward; }
@@ -43,6 +68,12 @@ protected:
 	UPROPERTY()
 	AMCharacter* InterlocutorCharacter;
 
+	/** Mob -> the player it speaks to. Each player speaks to one mob at most */
+	TMap<TWeakObjectPtr<const AMCharacter>, TWeakObjectPtr<AMCharacter>> Conversations;
+
+	/** (Mob, player) -> attitude of the mob to the player */
+	TMap<TPair<TObjectKey<AActor>, TObjectKey<AActor>>, ETeamAttitude::Type> AttitudeCache;
+
 	UPROPERTY()
 	class UMCommunicationWidget* CommunicationWidget;
 
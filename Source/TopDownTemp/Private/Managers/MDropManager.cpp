@@ -82,8 +82,7 @@ void UMDropManager::SpawnPickableItem(const AActor* Owner, const FItem& Item) //
 				PickableActor->InitialiseInventory({Item});
 
 				// Bind the single slot to OnChanged delegate
-				auto& Slot = PickableActor->GetInventoryComponent()->GetSlots()[0];
-				Slot.OnSlotChangedDelegate.AddDynamic(PickableActor, &AMPickableActor::OnItemChanged);
+				PickableActor->GetInventoryComponent()->GetSlotChangedDelegate(0).AddDynamic(PickableActor, &AMPickableActor::OnItemChanged);
 			}
 		});
 		WorldGenerator->SpawnActorInRadius<AMPickableActor>(AMPickableItemBPClass, OwnerLocation, FRotator::ZeroRotator, {}, 25.f, 0.f, OnActorSpawned);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/Sort.h"
+
+/** Shared addressing for the world grid hierarchy: blocks -> chunks -> regions.\n
+ * All the conversions are integer only, the keys are packed into 64 bits. */
+namespace MGridAddressing
+{
+	/** Division rounding towards negative infinity, i.e. -1 / 4 = -1. Divisor must be positive */
+	FORCEINLINE int32 FloorDiv(const int32 Dividend, const int32 Divisor)
+	{
+		checkSlow(Divisor > 0);
+		const int32 Quotient = Dividend / Divisor;
+		return (Dividend % Divisor != 0 && Dividend < 0) ? Quotient - 1 : Quotient;
+	}
+
+	/** Index of the cell of the upper level containing the given one. E.g. chunk of a block */
+	FORCEINLINE FIntPoint GetParentIndex(const FIntPoint& Index, const FIntPoint& ParentSize)
+	{
+		return { FloorDiv(Index.X, ParentSize.X), FloorDiv(Index.Y, ParentSize.Y) };
+	}
+
+	/** Index of the bottom left cell of the lower level within the given one. E.g. first block of a chunk */
+	FORCEINLINE FIntPoint GetFirstChildIndex(const FIntPoint& Index, const FIntPoint& ParentSize)
+	{
+		return Index * ParentSize;
+	}
+
+	FORCEINLINE uint64 PackKey(const FIntPoint& Index)
+	{
+		return static_cast<uint64>(static_cast<uint32>(Index.X)) << 32 | static_cast<uint32>(Index.Y);
+	}
+
+	FORCEINLINE FIntPoint UnpackKey(const uint64 Key)
+	{
+		return { static_cast<int32>(static_cast<uint32>(Key >> 32)), static_cast<int32>(static_cast<uint32>(Key)) };
+	}
+
+	/** Spreads 32 bits over the even bits of the result */
+	FORCEINLINE uint64 SpreadBits(uint64 Value)
+	{
+		Value = (Value | Value << 16) & 0x0000FFFF0000FFFFull;
+		Value = (Value | Value << 8) & 0x00FF00FF00FF00FFull;
+		Value = (Value | Value << 4) & 0x0F0F0F0F0F0F0F0Full;
+		Value = (Value | Value << 2) & 0x3333333333333333ull;
+		Value = (Value | Value << 1) & 0x5555555555555555ull;
+		return Value;
+	}
+
+	/** Z-order curve key. Cells close on the grid are close in this order, negative indices included */
+	FORCEINLINE uint64 MortonKey(const FIntPoint& Index)
+	{
+		// Flip the sign bit so that negative coordinates go before positive ones
+		const uint32 X = static_cast<uint32>(Index.X) ^ 0x80000000u;
+		const uint32 Y = static_cast<uint32>(Index.Y) ^ 0x80000000u;
+		return SpreadBits(X) | SpreadBits(Y) << 1;
+	}
+
+	/** Mixes all the bits of the packed key. Neighbouring cells end up in different buckets */
+	FORCEINLINE uint32 HashKey(const FIntPoint& Index)
+	{
+		uint64 Key = PackKey(Index);
+		Key ^= Key >> 33;
+		Key *= 0xff51afd7ed558ccdull;
+		Key ^= Key >> 33;
+		Key *= 0xc4ceb9fe1a85ec53ull;
+		Key ^= Key >> 33;
+		return static_cast<uint32>(Key);
+	}
+
+	template<typename ContainerType>
+	void SortByMorton(ContainerType& Indices)
+	{
+		Algo::SortBy(Indices, [](const FIntPoint& Index) { return MortonKey(Index); });
+	}
+
+	template<typename SetType>
+	TArray<FIntPoint> ToMortonArray(const SetType& Indices)
+	{
+		TArray<FIntPoint> Result = Indices.Array();
+		SortByMorton(Result);
+		return Result;
+	}
+}
+
+struct FMGridSetKeyFuncs : DefaultKeyFuncs<FIntPoint>
+{
+	static FORCEINLINE uint32 GetKeyHash(const FIntPoint& Key) { return MGridAddressing::HashKey(Key); }
+};
+
+template<typename ValueType>
+struct TMGridMapKeyFuncs : TDefaultMapHashableKeyFuncs<FIntPoint, ValueType, false>
+{
+	static FORCEINLINE uint32 GetKeyHash(const FIntPoint& Key) { return MGridAddressing::HashKey(Key); }
+};
+
+/** Set of grid indices. Can't be a UPROPERTY, so only for plain data */
+using FMGridSet = TSet<FIntPoint, FMGridSetKeyFuncs>;
+
+/** Map keyed by grid indices. Can't be a UPROPERTY, so only for values not referencing UObjects */
+template<typename ValueType>
+using TMGridMap = TMap<FIntPoint, ValueType, FDefaultSetAllocator, TMGridMapKeyFuncs<ValueType>>;
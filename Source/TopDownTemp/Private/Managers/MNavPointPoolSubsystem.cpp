@@ -0,0 +1,139 @@
+#include "MNavPointPoolSubsystem.h"
+
+#include "NavigationSystem.h"
+#include "StationaryActors/Outposts/OutpostGenerators/MOutpostGenerator.h"
+
+void UMNavPointPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (const auto NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld))
+	{
+		NavigationSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UMNavPointPoolSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+bool UMNavPointPoolSubsystem::DrawPoint(const AMOutpostGenerator* Outpost, FVector& OutPoint)
+{
+	if (!IsValid(Outpost)) { check(false); return false; }
+
+	auto& Pool = Pools.FindOrAdd(Outpost);
+	if (Pool.Points.IsEmpty())
+	{
+		if (!Pool.Outpost.IsValid())
+		{
+			Pool.Outpost = Outpost;
+			PendingPools.AddUnique(Outpost);
+		}
+		++MissesNumber;
+		return false;
+	}
+
+	OutPoint = Pool.Points[FMath::RandRange(0, Pool.Points.Num() - 1)];
+	++HitsNumber;
+	return true;
+}
+
+void UMNavPointPoolSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMNavPointPoolSubsystem::Tick);
+
+	const auto NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavigationSystem)
+		return;
+
+	int32 Budget = MaxProjectionsPerFrame;
+	for (int32 i = PendingPools.Num() - 1; i >= 0 && Budget > 0; --i)
+	{
+		const auto Pool = Pools.Find(PendingPools[i]);
+		if (!Pool || !Pool->Outpost.IsValid())
+		{
+			Pools.Remove(PendingPools[i]);
+			PendingPools.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		if (ProcessPool(*NavigationSystem, *Pool, Budget))
+		{
+			PendingPools.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+TStatId UMNavPointPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMNavPointPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UMNavPointPoolSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	// Tiles might have been added under empty pools or removed under filled ones. Check everything again
+	for (auto& [Key, Pool] : Pools)
+	{
+		Pool.RefreshIndex = Pool.Points.IsEmpty() ? INDEX_NONE : 0;
+		Pool.FailedSamplesNumber = 0;
+		PendingPools.AddUnique(Key);
+	}
+}
+
+bool UMNavPointPoolSubsystem::ProcessPool(UNavigationSystemV1& NavigationSystem, FMNavPointPool& Pool, int32& Budget)
+{
+	const auto Outpost = Pool.Outpost.Get();
+
+	// Points are still served while being checked, so drop the ones that aren't on the navmesh anymore right away
+	while (Pool.RefreshIndex != INDEX_NONE && Budget > 0)
+	{
+		--Budget;
+		++ProjectionsNumber;
+		auto& Point = Pool.Points[Pool.RefreshIndex];
+		FNavLocation NavLocation;
+		if (NavigationSystem.ProjectPointToNavigation(Point, NavLocation) && FVector::DistSquared(Point, NavLocation.Location) <= FMath::Square(RefreshTolerance))
+		{
+			Point = NavLocation.Location;
+			++Pool.RefreshIndex;
+		}
+		else
+		{
+			Pool.Points.RemoveAtSwap(Pool.RefreshIndex, 1, false);
+		}
+
+		if (!Pool.Points.IsValidIndex(Pool.RefreshIndex))
+		{
+			Pool.RefreshIndex = INDEX_NONE;
+		}
+	}
+
+	while (Pool.Points.Num() < PoolSize && Budget > 0)
+	{
+		--Budget;
+		FVector Point;
+		if (SamplePoint(NavigationSystem, *Outpost, Point))
+		{
+			Pool.Points.Add(Point);
+			Pool.FailedSamplesNumber = 0;
+		}
+		else if (++Pool.FailedSamplesNumber >= PoolSize)
+		{
+			// No navmesh here yet. Wait for it to be generated instead of burning the budget every frame
+			return Pool.RefreshIndex == INDEX_NONE;
+		}
+	}
+
+	return Pool.RefreshIndex == INDEX_NONE && Pool.Points.Num() >= PoolSize;
+}
+
+bool UMNavPointPoolSubsystem::SamplePoint(UNavigationSystemV1& NavigationSystem, const AMOutpostGenerator& Outpost, FVector& OutPoint)
+{
+	++ProjectionsNumber;
+
+	const float RandomAngle = FMath::RandRange(0.f, 2.f * PI);
+	const float RandomRadius = FMath::FRand() * Outpost.GetRadius();
+	const FVector RandomPoint = Outpost.GetActorLocation() + FVector(FMath::Cos(RandomAngle), FMath::Sin(RandomAngle), 0.f) * RandomRadius;
+
+	FNavLocation NavLocation;
+	if (!NavigationSystem.ProjectPointToNavigation(RandomPoint, NavLocation))
+		return false;
+
+	OutPoint = NavLocation.Location;
+	return true;
+}
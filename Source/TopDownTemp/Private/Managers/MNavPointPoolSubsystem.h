@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MNavPointPoolSubsystem.generated.h"
+
+class AMOutpostGenerator;
+class ANavigationData;
+class UNavigationSystemV1;
+
+/** Navigable points within an outpost, ready to be used as destinations */
+struct FMNavPointPool
+{
+	TWeakObjectPtr<const AMOutpostGenerator> Outpost;
+
+	TArray<FVector> Points;
+
+	/** Index of the next point to check after the navmesh changed. INDEX_NONE when all the points are up to date */
+	int32 RefreshIndex = INDEX_NONE;
+
+	/** Samples that missed the navmesh in a row. The pool stops filling if nothing is found, until the navmesh changes */
+	int32 FailedSamplesNumber = 0;
+};
+
+/** Gives villagers places to wander to without projecting random points to the navmesh on demand.\n
+ * Each outpost gets a pool of points, filled and refreshed with a fixed budget of projections per frame.
+ * Drawing a point is O(1). When the navmesh is rebuilt, the points are re-checked in the background while still being served. */
+UCLASS()
+class TOPDOWNTEMP_API UMNavPointPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** A random navigable point within the outpost. False if the pool has nothing yet, then it starts filling */
+	bool DrawPoint(const AMOutpostGenerator* Outpost, FVector& OutPoint);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !PendingPools.IsEmpty(); }
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	const TMap<TObjectKey<AMOutpostGenerator>, FMNavPointPool>& GetPools() const { return Pools; }
+
+	int64 GetHitsNumber() const { return HitsNumber; }
+
+	int64 GetMissesNumber() const { return MissesNumber; }
+
+	int64 GetProjectionsNumber() const { return ProjectionsNumber; }
+
+	void ResetStats() { HitsNumber = 0; MissesNumber = 0; ProjectionsNumber = 0; }
+
+protected:
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	/** Spends the budget on the pool. Returns true when the pool needs no more work */
+	bool ProcessPool(UNavigationSystemV1& NavigationSystem, FMNavPointPool& Pool, int32& Budget);
+
+	/** Same distribution as AMVillagerMobController::DoIdleBehavior used to project on demand */
+	bool SamplePoint(UNavigationSystemV1& NavigationSystem, const AMOutpostGenerator& Outpost, FVector& OutPoint);
+
+	static constexpr int32 PoolSize = 32;
+
+	static constexpr int32 MaxProjectionsPerFrame = 8;
+
+	/** Refreshed point is replaced if the navmesh moved further than that from it */
+	static constexpr float RefreshTolerance = 10.f;
+
+	TMap<TObjectKey<AMOutpostGenerator>, FMNavPointPool> Pools;
+
+	TArray<TObjectKey<AMOutpostGenerator>> PendingPools;
+
+	int64 HitsNumber = 0;
+
+	int64 MissesNumber = 0;
+
+	int64 ProjectionsNumber = 0;
+};
@@ -0,0 +1,88 @@
+#include "MPathRequestSubsystem.h"
+
+#include "Controllers/MMobControllerBase.h"
+#include "Navigation/PathFollowingComponent.h"
+
+void UMPathRequestSubsystem::RequestMove(AMMobControllerBase* Controller, const FVector& Goal, float AcceptanceRadius, bool bStopOnOverlap)
+{
+	if (!Controller)
+	{
+		check(false);
+		return;
+	}
+
+	// Already on the way to about the same place
+	if (const auto IssuedGoal = IssuedGoals.Find(Controller);
+		IssuedGoal && FVector::DistSquared(*IssuedGoal, Goal) <= FMath::Square(RepathThreshold) &&
+		Controller->GetMoveStatus() != EPathFollowingStatus::Idle)
+	{
+		++CoalescedNumber;
+		return;
+	}
+
+	// Still waiting, only the latest goal matters. Keep the place in the queue
+	if (const auto QueuedRequest = Queue.FindByPredicate([Controller](const FPathRequest& Request) { return Request.Controller == Controller; }))
+	{
+		QueuedRequest->Goal = Goal;
+		QueuedRequest->AcceptanceRadius = AcceptanceRadius;
+		QueuedRequest->bStopOnOverlap = bStopOnOverlap;
+		++CoalescedNumber;
+		return;
+	}
+
+	auto& Request = Queue.AddDefaulted_GetRef();
+	Request.Controller = Controller;
+	Request.Goal = Goal;
+	Request.AcceptanceRadius = AcceptanceRadius;
+	Request.bStopOnOverlap = bStopOnOverlap;
+	Request.RequestTime = FPlatformTime::Seconds();
+}
+
+void UMPathRequestSubsystem::CancelMove(const AMMobControllerBase* Controller)
+{
+	Queue.RemoveAll([Controller](const FPathRequest& Request) { return Request.Controller == Controller; });
+	IssuedGoals.Remove(Controller);
+}
+
+void UMPathRequestSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMPathRequestSubsystem::Tick);
+
+	const int32 RequestsNumber = FMath::Min(Queue.Num(), MaxRequestsPerFrame);
+	const double Now = FPlatformTime::Seconds();
+	for (int32 i = 0; i < RequestsNumber; ++i)
+	{
+		const auto& Request = Queue[i];
+		const auto Controller = Request.Controller.Get();
+		if (!Controller)
+			continue;
+
+		IssuedGoals.Add(Controller, Request.Goal);
+		Controller->MoveToLocation(Request.Goal, Request.AcceptanceRadius, Request.bStopOnOverlap);
+
+		TotalLatency += Now - Request.RequestTime;
+		++IssuedNumber;
+	}
+	Queue.RemoveAt(0, RequestsNumber, false);
+
+	// Controllers are destroyed along with their mobs
+	for (auto It = IssuedGoals.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TStatId UMPathRequestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMPathRequestSubsystem, STATGROUP_Tickables);
+}
+
+void UMPathRequestSubsystem::ResetStats()
+{
+	TotalLatency = 0.;
+	IssuedNumber = 0;
+	CoalescedNumber = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MPathRequestSubsystem.generated.h"
+
+class AMMobControllerBase;
+
+/** Broker between mob controllers and the navigation system.\n
+ * A request is dropped if the controller already moves to nearly the same goal, a newer request replaces the queued one,
+ * and only MaxRequestsPerFrame paths are found per frame. */
+UCLASS()
+class TOPDOWNTEMP_API UMPathRequestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Same parameters as AAIController::MoveToLocation */
+	void RequestMove(AMMobControllerBase* Controller, const FVector& Goal, float AcceptanceRadius, bool bStopOnOverlap);
+
+	/** Drops the queued request of the controller and forgets its goal, so the next request is never coalesced */
+	void CancelMove(const AMMobControllerBase* Controller);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !Queue.IsEmpty(); }
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	int32 GetQueueDepth() const { return Queue.Num(); }
+
+	/** Average time between a request and the actual pathfinding, in milliseconds */
+	double GetAverageLatencyMs() const { return IssuedNumber > 0 ? TotalLatency * 1000. / IssuedNumber : 0.; }
+
+	int64 GetIssuedNumber() const { return IssuedNumber; }
+
+	int64 GetCoalescedNumber() const { return CoalescedNumber; }
+
+	void ResetStats();
+
+protected:
+	struct FPathRequest
+	{
+		TWeakObjectPtr<AMMobControllerBase> Controller;
+		FVector Goal = FVector::ZeroVector;
+		float AcceptanceRadius = -1.f;
+		bool bStopOnOverlap = true;
+		double RequestTime = 0.;
+	};
+
+	/** A moving controller doesn't repath until its goal moves further than this */
+	static constexpr float RepathThreshold = 50.f;
+
+	static constexpr int32 MaxRequestsPerFrame = 8;
+
+	/** Served in the order of requests */
+	TArray<FPathRequest> Queue;
+
+	/** The goals the controllers currently move to */
+	TMap<TWeakObjectPtr<AMMobControllerBase>, FVector> IssuedGoals;
+
+	double TotalLatency = 0.;
+
+	int64 IssuedNumber = 0;
+
+	int64 CoalescedNumber = 0;
+};
@@ -0,0 +1,189 @@
+#include "MPerceptionSubsystem.h"
+
+#include "Characters/MCharacter.h"
+#include "Components/MStatsModelComponent.h"
+
+void UMPerceptionSubsystem::RegisterCharacter(AMCharacter* Character)
+{
+	if (!Character)
+	{
+		check(false);
+		return;
+	}
+
+	Characters.AddUnique(Character);
+}
+
+void UMPerceptionSubsystem::UnregisterCharacter(AMCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+	Observers.Remove(Character);
+}
+
+const TArray<FMPerceivedCharacter>& UMPerceptionSubsystem::GetPerceived(const AMCharacter* Observer)
+{
+	bool bNewObserver = false;
+	auto* ObserverData = Observers.Find(Observer);
+	if (!ObserverData)
+	{
+		ObserverData = &Observers.Add(Observer);
+		bNewObserver = true;
+	}
+	ObserverData->LastQueryTime = GetWorld()->GetTimeSeconds();
+
+	// Callers act on the results right away, e.g. an empty one would make a hiding villager disembark next to enemies
+	if (bNewObserver)
+	{
+		ComputePerceivedDirectly(Observer, ObserverData->Perceived);
+	}
+	return ObserverData->Perceived;
+}
+
+void UMPerceptionSubsystem::ComputePerceivedDirectly(const AMCharacter* Observer, TArray<FMPerceivedCharacter>& OutPerceived) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMPerceptionSubsystem::ComputePerceivedDirectly);
+
+	OutPerceived.Reset();
+	if (!Observer)
+		return;
+
+	const auto ObserverLocation = Observer->GetActorLocation();
+	const float RangeSquared = FMath::Square(GetPerceptionRange(Observer));
+	for (const auto& Character : Characters)
+	{
+		if (!Character.IsValid() || Character.Get() == Observer)
+			continue;
+
+		const float DistanceSquared = FVector::DistSquared(ObserverLocation, Character->GetActorLocation());
+		if (DistanceSquared > RangeSquared)
+			continue;
+
+		auto& Perceived = OutPerceived.AddDefaulted_GetRef();
+		Perceived.Character = Character;
+		Perceived.Distance = FMath::Sqrt(DistanceSquared);
+		Perceived.Attitude = FGenericTeamId::GetAttitude(Observer, Character.Get());
+	}
+
+	OutPerceived.Sort([](const FMPerceivedCharacter& A, const FMPerceivedCharacter& B) { return A.Distance < B.Distance; });
+}
+
+void UMPerceptionSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceLastUpdate += DeltaTime;
+	if (TimeSinceLastUpdate < PerceptionInterval)
+		return;
+	TimeSinceLastUpdate = 0.f;
+
+	UpdatePerception();
+}
+
+TStatId UMPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UMPerceptionSubsystem::UpdatePerception()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMPerceptionSubsystem::UpdatePerception);
+
+	LastPairsNumber = 0;
+
+	// Broadphase. Cells left empty by the previous update are dropped, so the grid doesn't grow with every area ever visited
+	for (auto It = Grid.CreateIterator(); It; ++It)
+	{
+		if (It->Value.IsEmpty())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		It->Value.Reset();
+	}
+	for (int32 i = Characters.Num() - 1; i >= 0; --i)
+	{
+		if (!Characters[i].IsValid())
+		{
+			Characters.RemoveAtSwap(i, 1, false);
+		}
+	}
+	TArray<FVector> Locations;
+	Locations.Reserve(Characters.Num());
+	TMap<const AMCharacter*, int32> IndexByCharacter;
+	IndexByCharacter.Reserve(Characters.Num());
+	for (int32 i = 0; i < Characters.Num(); ++i)
+	{
+		const auto Location = Characters[i]->GetActorLocation();
+		Locations.Add(Location);
+		IndexByCharacter.Add(Characters[i].Get(), i);
+		const FIntPoint Cell(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+		Grid.FindOrAdd(Cell).Add(i);
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (auto It = Observers.CreateIterator(); It; ++It)
+	{
+		auto& [Observer, ObserverData] = *It;
+		const int32* ObserverIndexPtr = IndexByCharacter.Find(Observer);
+		if (!ObserverIndexPtr || Now - ObserverData.LastQueryTime > ObserverTimeout)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		const int32 ObserverIndex = *ObserverIndexPtr;
+
+		ObserverData.Perceived.Reset();
+		const auto& ObserverLocation = Locations[ObserverIndex];
+		const float Range = GetPerceptionRange(Observer);
+		const float RangeSquared = FMath::Square(Range);
+
+		const FIntPoint MinCell(FMath::FloorToInt32((ObserverLocation.X - Range) / CellSize), FMath::FloorToInt32((ObserverLocation.Y - Range) / CellSize));
+		const FIntPoint MaxCell(FMath::FloorToInt32((ObserverLocation.X + Range) / CellSize), FMath::FloorToInt32((ObserverLocation.Y + Range) / CellSize));
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				const auto* Indices = Grid.Find({X, Y});
+				if (!Indices)
+					continue;
+
+				for (const int32 Index : *Indices)
+				{
+					++LastPairsNumber;
+					const float DistanceSquared = FVector::DistSquared(ObserverLocation, Locations[Index]);
+					if (Index == ObserverIndex || DistanceSquared > RangeSquared)
+						continue;
+
+					auto& Perceived = ObserverData.Perceived.AddDefaulted_GetRef();
+					Perceived.Character = Characters[Index];
+					Perceived.Distance = FMath::Sqrt(DistanceSquared);
+					Perceived.Attitude = FGenericTeamId::GetAttitude(Observer, Characters[Index].Get());
+				}
+			}
+		}
+
+		ObserverData.Perceived.Sort([](const FMPerceivedCharacter& A, const FMPerceivedCharacter& B) { return A.Distance < B.Distance; });
+	}
+}
+
+void UMPerceptionSubsystem::ObserveAll()
+{
+	// Without the direct computation of GetPerceived(), the next update fills them all at once
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (const auto& Character : Characters)
+	{
+		if (Character.IsValid())
+		{
+			Observers.FindOrAdd(Character.Get()).LastQueryTime = Now;
+		}
+	}
+}
+
+float UMPerceptionSubsystem::GetPerceptionRange(const AMCharacter* Observer)
+{
+	// Mobs see enemies within the sight range and keep track of them until the forget range
+	if (const auto StatsModel = Observer->GetStatsModelComponent())
+	{
+		return FMath::Max(StatsModel->GetSightRange(), StatsModel->GetForgetEnemyRange());
+	}
+	check(false);
+	return 0.f;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericTeamAgentInterface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Managers/MGridAddressing.h"
+#include "MPerceptionSubsystem.generated.h"
+
+class AMCharacter;
+
+struct FMPerceivedCharacter
+{
+	TWeakObjectPtr<AMCharacter> Character;
+
+	float Distance = 0.f;
+
+	/** Attitude of the observer to the character */
+	ETeamAttitude::Type Attitude = ETeamAttitude::Neutral;
+};
+
+/** Computes who perceives whom for all the mobs at once, instead of every mob scanning the area around itself.\n
+ * Characters are put into a broadphase grid once per perception update, so the cost grows with the crowd density, not its square.\n
+ * A character becomes an observer as soon as it asks for its results, and stops being one when it stops asking.\n
+ * The very first results of an observer are computed on the spot, so they are never empty just because it's new. */
+UCLASS()
+class TOPDOWNTEMP_API UMPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterCharacter(AMCharacter* Character);
+
+	void UnregisterCharacter(AMCharacter* Character);
+
+	/** Characters within the observer's perception range, the closest first.\n
+	 * The first call of a new observer computes them right away, later ones return what the last perception update found */
+	const TArray<FMPerceivedCharacter>& GetPerceived(const AMCharacter* Observer);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !Observers.IsEmpty(); }
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	/** Rebuilds the grid and the results of all the observers */
+	void UpdatePerception();
+
+	/** Makes every registered character an observer */
+	void ObserveAll();
+
+	int32 GetCharactersNumber() const { return Characters.Num(); }
+
+	int32 GetObserversNumber() const { return Observers.Num(); }
+
+	/** Pairs of characters checked during the last update */
+	int32 GetLastPairsNumber() const { return LastPairsNumber; }
+
+protected:
+	struct FObserverData
+	{
+		TArray<FMPerceivedCharacter> Perceived;
+
+		/** Observers that stopped asking for the results are dropped */
+		double LastQueryTime = 0.;
+	};
+
+	static float GetPerceptionRange(const AMCharacter* Observer);
+
+	/** Checks every registered character against the observer, without the grid. Only for observers the last update didn't know */
+	void ComputePerceivedDirectly(const AMCharacter* Observer, TArray<FMPerceivedCharacter>& OutPerceived) const;
+
+	static constexpr float CellSize = 1000.f;
+
+	static constexpr float PerceptionInterval = 0.1f;
+
+	static constexpr double ObserverTimeout = 1.;
+
+	TArray<TWeakObjectPtr<AMCharacter>> Characters;
+
+	TMap<const AMCharacter*, FObserverData> Observers;
+
+	/** Indices in Characters per cell. Rebuilt every update, the arrays of occupied cells keep their memory */
+	TMGridMap<TArray<int32>> Grid;
+
+	float TimeSinceLastUpdate = 0.f;
+
+	int32 LastPairsNumber = 0;
+};
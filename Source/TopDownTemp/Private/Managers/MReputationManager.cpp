@@ -1,5 +1,19 @@
 #include "MReputationManager.h"
 
+#include "Framework/MGameMode.h"
+#include "Managers/MCommunicationManager.h"
+
+void UMReputationManager::Initialize(const TMap<EFaction, FReputation>& IN_ReputationMap)
+{
+	ReputationMap = IN_ReputationMap;
+
+	// Attitudes cached before the change are outdated
+	if (const auto CommunicationManager = AMGameMode::GetCommunicationManager(this))
+	{
+		CommunicationManager->InvalidateAttitudes();
+	}
+}
+
 FReputation UMReputationManager::GetReputation(EFaction IN_Faction)
 {
 	if (const auto Reputation = ReputationMap.Find(IN_Faction))
@@ -36,7 +36,7 @@ class TOPDOWNTEMP_API UMReputationManager : public UObject
 
 public:
 	GENERATED_BODY()
-	void Initialize(const TMap<EFaction, FReputation>& IN_ReputationMap) { ReputationMap = IN_ReputationMap; }
+	void Initialize(const TMap<EFaction, FReputation>& IN_ReputationMap);
 
 	UFUNCTION(BlueprintCallable)
 	FReputation GetReputation(EFaction IN_Faction);
@@ -0,0 +1,122 @@
+#include "MShadowSubsystem.h"
+
+#include "TopDownTemp.h"
+#include "Components/M2DShadowControllerComponent.h"
+#include "Engine/DirectionalLight.h"
+#include "Kismet/GameplayStatics.h"
+
+void UMShadowSubsystem::RegisterShadow(UM2DShadowControllerComponent* Shadow)
+{
+	if (!Shadow)
+	{
+		check(false);
+		return;
+	}
+
+	Shadows.AddUnique(Shadow);
+
+	// The first shadows are registered before the first tick
+	if (!bHasShadowRotation && (IsValid(DirectionalLight) || FindDirectionalLight(0.f)))
+	{
+		UpdateLightDirection();
+	}
+	if (bHasShadowRotation)
+	{
+		Shadow->SetShadowRotation(ShadowRotation);
+		return;
+	}
+	NewShadows.AddUnique(Shadow);
+}
+
+void UMShadowSubsystem::UnregisterShadow(UM2DShadowControllerComponent* Shadow)
+{
+	Shadows.RemoveSingleSwap(Shadow);
+	NewShadows.RemoveSingleSwap(Shadow);
+}
+
+void UMShadowSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMShadowSubsystem::Tick);
+
+	LastFrameUpdatesNumber = 0;
+
+	if (!IsValid(DirectionalLight) && !FindDirectionalLight(DeltaTime))
+	{
+		return;
+	}
+
+	if (!UpdateLightDirection())
+	{
+		// The sun is static, only the new shadows need to be turned
+		if (NewShadows.IsEmpty())
+		{
+			++StaticFramesNumber;
+			return;
+		}
+		UpdateShadows(NewShadows);
+		NewShadows.Reset();
+		return;
+	}
+
+	UpdateShadows(Shadows);
+	NewShadows.Reset();
+}
+
+bool UMShadowSubsystem::UpdateLightDirection()
+{
+	// Perpendicular to the light source
+	auto NewShadowRotation = DirectionalLight->GetTransform().Rotator();
+	NewShadowRotation.Pitch = 0.f;
+	NewShadowRotation.Yaw += 90.f;
+	NewShadowRotation.Roll = 0.f;
+
+	if (bHasShadowRotation && NewShadowRotation.Equals(ShadowRotation))
+	{
+		return false;
+	}
+
+	ShadowRotation = NewShadowRotation;
+	LightDirection = DirectionalLight->GetActorForwardVector();
+	bHasShadowRotation = true;
+	OnLightDirectionChanged.Broadcast(LightDirection);
+	return true;
+}
+
+TStatId UMShadowSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMShadowSubsystem, STATGROUP_Tickables);
+}
+
+bool UMShadowSubsystem::FindDirectionalLight(float DeltaTime)
+{
+	LightLookupCooldown -= DeltaTime;
+	if (LightLookupCooldown > 0.f)
+	{
+		return false;
+	}
+
+	// The only full actor iteration, instead of one per shadow
+	DirectionalLight = Cast<ADirectionalLight>(UGameplayStatics::GetActorOfClass(this, ADirectionalLight::StaticClass()));
+	if (!DirectionalLight)
+	{
+		LightLookupCooldown = LightLookupInterval;
+		UE_LOG(LogTopDownTemp, Warning, TEXT("UMShadowSubsystem: no directional light in the world, shadows aren't turned"));
+		return false;
+	}
+
+	bHasShadowRotation = false; // A different light, update everything
+	return true;
+}
+
+void UMShadowSubsystem::UpdateShadows(const TArray<UM2DShadowControllerComponent*>& ShadowsToUpdate)
+{
+	for (const auto Shadow : ShadowsToUpdate)
+	{
+		if (IsValid(Shadow))
+		{
+			Shadow->SetShadowRotation(ShadowRotation);
+		}
+	}
+	LastFrameUpdatesNumber += ShadowsToUpdate.Num();
+	TotalUpdatesNumber += ShadowsToUpdate.Num();
+}
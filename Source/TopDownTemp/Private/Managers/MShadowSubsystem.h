@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MShadowSubsystem.generated.h"
+
+class ADirectionalLight;
+class UM2DShadowControllerComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnLightDirectionChanged, const FVector& /*LightDirection*/);
+
+/** Keeps the directional light of the world and turns all the 2D shadows perpendicularly to it.\n
+ * Shadows are updated in one pass and only when the light turns, or once right after they are registered. */
+UCLASS()
+class TOPDOWNTEMP_API UMShadowSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Turns the shadow right away if the light is already known, so the light direction is valid before the first tick */
+	void RegisterShadow(UM2DShadowControllerComponent* Shadow);
+
+	void UnregisterShadow(UM2DShadowControllerComponent* Shadow);
+
+	/** Forward vector of the directional light. Zero while there is no light */
+	const FVector& GetLightDirection() const { return LightDirection; }
+
+	/** Broadcast whenever the light turns, including when the direction is found for the first time */
+	FOnLightDirectionChanged OnLightDirectionChanged;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	int32 GetShadowsNumber() const { return Shadows.Num(); }
+
+	int32 GetLastFrameUpdatesNumber() const { return LastFrameUpdatesNumber; }
+
+	int64 GetTotalUpdatesNumber() const { return TotalUpdatesNumber; }
+
+	/** Frames that took the fast path: the light didn't turn and there were no new shadows */
+	int64 GetStaticFramesNumber() const { return StaticFramesNumber; }
+
+protected:
+	/** Searches the world for the directional light. Doesn't search more often than once in LightLookupInterval */
+	bool FindDirectionalLight(float DeltaTime);
+
+	/** Reads the rotation and the direction of the current light. Returns true if the shadows have to be turned */
+	bool UpdateLightDirection();
+
+	void UpdateShadows(const TArray<UM2DShadowControllerComponent*>& ShadowsToUpdate);
+
+	UPROPERTY()
+	ADirectionalLight* DirectionalLight = nullptr;
+
+	UPROPERTY()
+	TArray<UM2DShadowControllerComponent*> Shadows;
+
+	/** Registered since the last pass. Need the rotation even if the light is static */
+	UPROPERTY()
+	TArray<UM2DShadowControllerComponent*> NewShadows;
+
+	FRotator ShadowRotation = FRotator::ZeroRotator;
+
+	FVector LightDirection = FVector::ZeroVector;
+
+	bool bHasShadowRotation = false;
+
+	static constexpr float LightLookupInterval = 1.f;
+
+	float LightLookupCooldown = 0.f;
+
+	int32 LastFrameUpdatesNumber = 0;
+
+	int64 TotalUpdatesNumber = 0;
+
+	int64 StaticFramesNumber = 0;
+};
@@ -0,0 +1,160 @@
+#include "MSquadSubsystem.h"
+
+#include "Characters/MCharacter.h"
+#include "Components/CapsuleComponent.h"
+
+void UMSquadSubsystem::Join(const AActor* Victim, const AMCharacter* Member)
+{
+	if (!IsValid(Victim) || !IsValid(Member)) { check(false); return; }
+
+	RemoveInvalidSquads();
+
+	if (const auto SquadKey = SquadByMember.Find(Member))
+	{
+		if (*SquadKey == TObjectKey<AActor>(Victim))
+			return;
+		Leave(Member);
+	}
+
+	auto& Squad = Squads.FindOrAdd(Victim);
+	if (Squad.Members.IsEmpty())
+	{
+		Squad.Victim = Victim;
+		Squad.Anchor = Victim->GetActorLocation();
+	}
+	Squad.Members.Add({Member, Member});
+	SquadByMember.Add(Member, Victim);
+
+	AssignSlots(Squad);
+}
+
+void UMSquadSubsystem::Leave(const AMCharacter* Member)
+{
+	TObjectKey<AActor> SquadKey;
+	if (!SquadByMember.RemoveAndCopyValue(Member, SquadKey))
+		return;
+
+	if (const auto Squad = Squads.Find(SquadKey))
+	{
+		Squad->Members.RemoveAllSwap([Member](const FMSquadMember& SquadMember) { return SquadMember.Key == TObjectKey<AMCharacter>(Member); });
+		if (Squad->Members.IsEmpty() || !Squad->Victim.IsValid())
+		{
+			RemoveSquad(SquadKey);
+		}
+		else
+		{
+			AssignSlots(*Squad);
+		}
+	}
+}
+
+FVector UMSquadSubsystem::GetSlotLocation(const AMCharacter* Member, float Distance)
+{
+	const auto SquadKey = SquadByMember.Find(Member);
+	const auto Squad = SquadKey ? Squads.Find(*SquadKey) : nullptr;
+	if (!Squad)
+	{
+		check(false);
+		return IsValid(Member) ? Member->GetActorLocation() : FVector::ZeroVector;
+	}
+	if (!Squad->Victim.IsValid())
+	{
+		RemoveSquad(*SquadKey);
+		return IsValid(Member) ? Member->GetActorLocation() : FVector::ZeroVector;
+	}
+
+	const auto VictimLocation = Squad->Victim->GetActorLocation();
+	if (FVector::DistSquared2D(VictimLocation, Squad->Anchor) > FMath::Square(AnchorUpdateDistance))
+	{
+		Squad->Anchor = VictimLocation;
+	}
+
+	const auto SquadMember = Squad->Members.FindByPredicate([Member](const FMSquadMember& Candidate) { return Candidate.Key == TObjectKey<AMCharacter>(Member); });
+	if (!SquadMember) { check(false); return VictimLocation; }
+
+	float Sin, Cos;
+	FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(SquadMember->SlotYaw));
+	return Squad->Anchor + FVector(Cos, Sin, 0.f) * FMath::Max(Distance, Squad->MinSlotDistance);
+}
+
+void UMSquadSubsystem::AssignSlots(FMSquad& Squad)
+{
+	++AssignmentsNumber;
+
+	Squad.Members.RemoveAllSwap([this](const FMSquadMember& Member)
+	{
+		if (Member.Character.IsValid())
+			return false;
+		SquadByMember.Remove(Member.Key);
+		return true;
+	});
+	if (Squad.Members.IsEmpty() || !Squad.Victim.IsValid())
+		return;
+
+	// Keep the order members already surround the victim in, so they don't cross each other's way
+	const auto VictimLocation = Squad.Victim->GetActorLocation();
+	for (auto& Member : Squad.Members)
+	{
+		const auto ToMember = Member.Character->GetActorLocation() - VictimLocation;
+		Member.SlotYaw = FMath::RadiansToDegrees(FMath::Atan2(ToMember.Y, ToMember.X));
+	}
+	Squad.Members.Sort([](const FMSquadMember& A, const FMSquadMember& B) { return A.SlotYaw < B.SlotYaw; });
+
+	// Evenly spaced slots, turned to be as close as possible to where the members are. That's the circular mean of their offsets
+	const float Step = 360.f / Squad.Members.Num();
+	FVector2D OffsetsSum = FVector2D::ZeroVector;
+	for (int32 i = 0; i < Squad.Members.Num(); ++i)
+	{
+		const float Offset = FMath::DegreesToRadians(Squad.Members[i].SlotYaw - i * Step);
+		OffsetsSum += FVector2D(FMath::Cos(Offset), FMath::Sin(Offset));
+	}
+	const float BaseYaw = OffsetsSum.IsNearlyZero() ? Squad.Members[0].SlotYaw : FMath::RadiansToDegrees(FMath::Atan2(OffsetsSum.Y, OffsetsSum.X));
+
+	for (int32 i = 0; i < Squad.Members.Num(); ++i)
+	{
+		Squad.Members[i].SlotYaw = BaseYaw + i * Step;
+	}
+
+	// Neighbouring slots are a chord apart, which must fit two of the widest agents
+	Squad.MinSlotDistance = 0.f;
+	if (Squad.Members.Num() > 1)
+	{
+		float AgentRadius = 0.f;
+		for (const auto& Member : Squad.Members)
+		{
+			if (const auto CapsuleComponent = Member.Character->GetCapsuleComponent())
+			{
+				AgentRadius = FMath::Max(AgentRadius, CapsuleComponent->GetScaledCapsuleRadius());
+			}
+		}
+		Squad.MinSlotDistance = AgentRadius / FMath::Sin(PI / Squad.Members.Num());
+	}
+}
+
+void UMSquadSubsystem::RemoveSquad(TObjectKey<AActor> SquadKey)
+{
+	FMSquad Squad;
+	if (!Squads.RemoveAndCopyValue(SquadKey, Squad))
+		return;
+
+	for (const auto& SquadMember : Squad.Members)
+	{
+		SquadByMember.Remove(SquadMember.Key);
+	}
+}
+
+void UMSquadSubsystem::RemoveInvalidSquads()
+{
+	TArray<TObjectKey<AActor>, TInlineAllocator<4>> InvalidSquadKeys;
+	for (const auto& [SquadKey, Squad] : Squads)
+	{
+		if (!Squad.Victim.IsValid())
+		{
+			InvalidSquadKeys.Add(SquadKey);
+		}
+	}
+	for (const auto& SquadKey : InvalidSquadKeys)
+	{
+		RemoveSquad(SquadKey);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MSquadSubsystem.generated.h"
+
+class AMCharacter;
+
+struct FMSquadMember
+{
+	TWeakObjectPtr<const AMCharacter> Character;
+
+	/** Stays the same after the character is destroyed, so it can still be removed from the lookup */
+	TObjectKey<AMCharacter> Key;
+
+	/** Direction from the victim to the member's slot */
+	float SlotYaw = 0.f;
+};
+
+/** All the mobs attacking the same victim */
+struct FMSquad
+{
+	TWeakObjectPtr<const AActor> Victim;
+
+	TArray<FMSquadMember> Members;
+
+	/** Victim's location the slots are placed around. Follows the victim with a lag, so the slot goals stay the same for small moves */
+	FVector Anchor = FVector::ZeroVector;
+
+	/** Slots are never closer to the victim than this, so neighbouring members of a large pack don't overlap */
+	float MinSlotDistance = 0.f;
+};
+
+/** Spreads mobs attacking the same victim around it, instead of each of them going straight to the victim.\n
+ * Members get evenly spaced slots, assigned in the order they already surround the victim, so nobody has to cross the pack.\n
+ * Slots are reassigned only when somebody joins or leaves. */
+UCLASS()
+class TOPDOWNTEMP_API UMSquadSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Join(const AActor* Victim, const AMCharacter* Member);
+
+	void Leave(const AMCharacter* Member);
+
+	/** Where the member should go to attack from the given distance. The victim's location if the member is not in a squad */
+	FVector GetSlotLocation(const AMCharacter* Member, float Distance);
+
+	static constexpr float SlotAcceptanceRadius = 25.f;
+
+public: // For debugging
+	/** When disabled, everyone goes straight to the victim as before */
+	void SetEnabled(bool bValue) { bEnabled = bValue; }
+
+	bool GetEnabled() const { return bEnabled; }
+
+	const TMap<TObjectKey<AActor>, FMSquad>& GetSquads() const { return Squads; }
+
+	/** Slot reassignments since the last reset */
+	int32 GetAssignmentsNumber() const { return AssignmentsNumber; }
+
+	void ResetStats() { AssignmentsNumber = 0; }
+
+protected:
+	void AssignSlots(FMSquad& Squad);
+
+	void RemoveSquad(TObjectKey<AActor> SquadKey);
+
+	/** Squads of destroyed victims would otherwise stay forever, with their members still registered */
+	void RemoveInvalidSquads();
+
+	/** Same as UMPathRequestSubsystem's repath threshold, smaller moves of the victim wouldn't cause a repath anyway */
+	static constexpr float AnchorUpdateDistance = 50.f;
+
+	TMap<TObjectKey<AActor>, FMSquad> Squads;
+
+	TMap<TObjectKey<AMCharacter>, TObjectKey<AActor>> SquadByMember;
+
+	bool bEnabled = true;
+
+	int32 AssignmentsNumber = 0;
+};
@@ -0,0 +1,219 @@
+#include "MVirtualSimulationSubsystem.h"
+
+#include "Characters/MCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/MIsActiveCheckerComponent.h"
+#include "Components/MStatsModelComponent.h"
+#include "Controllers/MMobControllerBase.h"
+#include "Framework/MGameMode.h"
+#include "Managers/MMetadataManager.h"
+#include "Managers/MWorldGenerator.h"
+#include "NavigationSystem.h"
+#include "StationaryActors/Outposts/MOutpostHouse.h"
+#include "StationaryActors/Outposts/OutpostGenerators/MOutpostGenerator.h"
+
+void UMVirtualSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Random.GenerateNewSeed();
+}
+
+void UMVirtualSimulationSubsystem::Virtualize(AMCharacter* Character)
+{
+	if (!IsValid(Character) || IndexByName.Contains(FName(Character->GetName())))
+		return;
+
+	// Only mobs wander around. Embarked villagers are disabled on purpose and stay where they are
+	if (!Cast<AMMobControllerBase>(Character->GetController()))
+		return;
+	if (const auto ActiveChecker = Character->GetIsActiveCheckerComponent(); !ActiveChecker || ActiveChecker->GetAlwaysDisabled())
+		return;
+
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!WorldGenerator) { check(false); return; }
+
+	FMVirtualMob Mob;
+	Mob.Character = Character;
+	Mob.Name = FName(Character->GetName());
+	Mob.Location = FVector2D(Character->GetActorLocation());
+	Mob.Goal = Mob.Location;
+	Mob.Home = Mob.Location;
+	Mob.HomeRadius = WanderRadius;
+	Mob.Speed = Character->GetStatsModelComponent() ? Character->GetStatsModelComponent()->GetWalkSpeed() : 0.f;
+	Mob.RestTimeLeft = Random.FRandRange(MinRestDuration, MaxRestDuration);
+	Mob.Block = WorldGenerator->GetGroundBlockIndex(Character->GetActorLocation());
+
+	if (const auto House = Character->GetHouse())
+	{
+		if (const auto Village = House->GetOwnerOutpost())
+		{
+			Mob.Home = FVector2D(Village->GetActorLocation());
+			Mob.HomeRadius = Village->GetRadius();
+		}
+	}
+
+	IndexByName.Add(Mob.Name, Mobs.Add(Mob));
+}
+
+void UMVirtualSimulationSubsystem::Devirtualize(AMCharacter* Character)
+{
+	if (!IsValid(Character))
+		return;
+
+	const auto Index = IndexByName.Find(FName(Character->GetName()));
+	if (!Index)
+		return;
+
+	const auto Mob = Mobs[*Index];
+	RemoveMob(*Index);
+
+	Character->SetActorLocation(GetStandingLocation(*Character, Mob.Location), false, nullptr, ETeleportType::TeleportPhysics);
+
+	// Whatever it was doing before being disabled was left far behind
+	if (const auto MobController = Cast<AMMobControllerBase>(Character->GetController()))
+	{
+		MobController->ResetBehavior();
+	}
+}
+
+TOptional<FVector> UMVirtualSimulationSubsystem::FindSimulatedLocation(const AMCharacter* Character) const
+{
+	if (!IsValid(Character))
+		return {};
+
+	if (const auto Index = IndexByName.Find(FName(Character->GetName())))
+	{
+		return GetStandingLocation(*Character, Mobs[*Index].Location);
+	}
+	return {};
+}
+
+void UMVirtualSimulationSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceLastSimulation += DeltaTime;
+	if (TimeSinceLastSimulation < SimulationInterval)
+		return;
+
+	Simulate(TimeSinceLastSimulation);
+	TimeSinceLastSimulation = 0.f;
+}
+
+TStatId UMVirtualSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMVirtualSimulationSubsystem, STATGROUP_Tickables);
+}
+
+void UMVirtualSimulationSubsystem::Advance(FMVirtualMob& Mob, float DeltaSeconds, FRandomStream& Random)
+{
+	while (DeltaSeconds > 0.f)
+	{
+		if (Mob.RestTimeLeft > 0.f)
+		{
+			const float RestTime = FMath::Min(Mob.RestTimeLeft, DeltaSeconds);
+			Mob.RestTimeLeft -= RestTime;
+			DeltaSeconds -= RestTime;
+			continue;
+		}
+
+		const auto ToGoal = Mob.Goal - Mob.Location;
+		const float Distance = ToGoal.Size();
+		const float Step = Mob.Speed * DeltaSeconds;
+		if (Step < Distance)
+		{
+			Mob.Location += ToGoal / Distance * Step;
+			return;
+		}
+
+		// Arrived. Rest, then go to a random point around home, same as AMVillagerMobController::DoIdleBehavior
+		Mob.Location = Mob.Goal;
+		DeltaSeconds -= Mob.Speed > 0.f ? Distance / Mob.Speed : DeltaSeconds;
+
+		const float RandomAngle = Random.FRandRange(0.f, 2.f * PI);
+		const float RandomRadius = Random.FRand() * Mob.HomeRadius;
+		Mob.Goal = Mob.Home + FVector2D(FMath::Cos(RandomAngle), FMath::Sin(RandomAngle)) * RandomRadius;
+		Mob.RestTimeLeft = Random.FRandRange(MinRestDuration, MaxRestDuration);
+	}
+}
+
+void UMVirtualSimulationSubsystem::Simulate(float DeltaSeconds)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMVirtualSimulationSubsystem::Simulate);
+
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	if (!WorldGenerator || !MetadataManager) { check(false); return; }
+
+	TArray<AMCharacter*> ToWakeUp;
+	for (int32 i = Mobs.Num() - 1; i >= 0; --i)
+	{
+		auto& Mob = Mobs[i];
+		const auto Character = Mob.Character.Get();
+		if (!Character)
+		{
+			RemoveMob(i);
+			continue;
+		}
+
+		const auto PreviousLocation = Mob.Location;
+		Advance(Mob, DeltaSeconds, Random);
+
+		// Keep the actor registered in the block it's in, so it's enabled along with that block
+		if (const auto Block = WorldGenerator->GetGroundBlockIndex(FVector(Mob.Location, 0.f)); Block != Mob.Block)
+		{
+			if (!MetadataManager->FindBlock(Block))
+			{
+				// The block was never generated, so there is nothing to register in. Stop at its border and head home
+				Mob.Location = PreviousLocation;
+				Mob.Goal = Mob.Home;
+				continue;
+			}
+
+			Mob.Block = Block;
+			Character->SetActorLocation(GetStandingLocation(*Character, Mob.Location), false, nullptr, ETeleportType::TeleportPhysics);
+			MetadataManager->MoveToBlock(Mob.Name, Block);
+			++BlockChangesNumber;
+
+			if (WorldGenerator->IsBlockActive(Block))
+			{
+				ToWakeUp.Add(Character);
+			}
+		}
+	}
+
+	// Enabling devirtualizes, so don't do it while iterating
+	for (const auto Character : ToWakeUp)
+	{
+		if (const auto ActiveChecker = Character->GetIsActiveCheckerComponent())
+		{
+			ActiveChecker->EnableOwner();
+			++WokenUpNumber;
+		}
+	}
+}
+
+FVector UMVirtualSimulationSubsystem::GetStandingLocation(const AMCharacter& Character, const FVector2D& Location) const
+{
+	FVector Result(Location, Character.GetActorLocation().Z);
+	FVector NavigatedLocation;
+	if (UNavigationSystemV1::K2_ProjectPointToNavigation(GetWorld(), Result, NavigatedLocation, nullptr, nullptr))
+	{
+		// The navmesh is on the ground, the actor origin is in the middle of the capsule
+		Result = NavigatedLocation;
+		if (const auto CapsuleComponent = Character.GetCapsuleComponent())
+		{
+			Result.Z += CapsuleComponent->GetScaledCapsuleHalfHeight();
+		}
+	}
+	return Result;
+}
+
+void UMVirtualSimulationSubsystem::RemoveMob(int32 Index)
+{
+	IndexByName.Remove(Mobs[Index].Name);
+	Mobs.RemoveAtSwap(Index, 1, false);
+	if (Mobs.IsValidIndex(Index))
+	{
+		IndexByName.Add(Mobs[Index].Name, Index);
+	}
+}
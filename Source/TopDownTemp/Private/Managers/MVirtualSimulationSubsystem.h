@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MVirtualSimulationSubsystem.generated.h"
+
+class AMCharacter;
+
+/** A disabled mob reduced to plain data */
+struct FMVirtualMob
+{
+	TWeakObjectPtr<AMCharacter> Character;
+
+	/** Metadata name */
+	FName Name;
+
+	FVector2D Location = FVector2D::ZeroVector;
+
+	FVector2D Goal = FVector2D::ZeroVector;
+
+	/** The mob wanders around it. Village center for villagers, the place it was disabled at for the others */
+	FVector2D Home = FVector2D::ZeroVector;
+
+	float HomeRadius = 0.f;
+
+	float Speed = 0.f;
+
+	/** Time to wait before walking to the goal */
+	float RestTimeLeft = 0.f;
+
+	/** The block the actor is registered in */
+	FIntPoint Block = FIntPoint::ZeroValue;
+};
+
+/** Keeps the world going where nobody sees it.\n
+ * Mobs disabled by UMIsActiveCheckerComponent are simulated coarsely as plain data: they rest and walk around their homes
+ * following the same schedule as active villagers. The actor is touched only when the mob crosses a block border,
+ * so it is registered where it actually is, and when it's enabled again, to put it where the simulation got to. */
+UCLASS()
+class TOPDOWNTEMP_API UMVirtualSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	void Virtualize(AMCharacter* Character);
+
+	/** Puts the character where its simulation got to. Called when the character is enabled again */
+	void Devirtualize(AMCharacter* Character);
+
+	/** Where the simulation got the character to, standing on the navmesh. Empty if the character isn't virtualized */
+	TOptional<FVector> FindSimulatedLocation(const AMCharacter* Character) const;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !Mobs.IsEmpty(); }
+
+	virtual TStatId GetStatId() const override;
+
+public: // For debugging
+	/** Advances a single mob. Doesn't touch any actors */
+	static void Advance(FMVirtualMob& Mob, float DeltaSeconds, FRandomStream& Random);
+
+	static constexpr float SimulationInterval = 1.f;
+
+	int32 GetMobsNumber() const { return Mobs.Num(); }
+
+	/** Block border crossings synced to the actors since the last reset */
+	int32 GetBlockChangesNumber() const { return BlockChangesNumber; }
+
+	/** Mobs that walked into an observer's zone and were enabled by the simulation since the last reset */
+	int32 GetWokenUpNumber() const { return WokenUpNumber; }
+
+	void ResetStats() { BlockChangesNumber = 0; WokenUpNumber = 0; }
+
+protected:
+	void Simulate(float DeltaSeconds);
+
+	void RemoveMob(int32 Index);
+
+	/** The simulation doesn't know about obstacles or the terrain, so find the closest place the character can actually stand at */
+	FVector GetStandingLocation(const AMCharacter& Character, const FVector2D& Location) const;
+
+	static constexpr float WanderRadius = 1000.f;
+
+	static constexpr float MinRestDuration = 1.5f;
+
+	static constexpr float MaxRestDuration = 4.5f;
+
+	TArray<FMVirtualMob> Mobs;
+
+	/** Metadata names are unique and, unlike pointers, stay valid after the character is destroyed */
+	TMap<FName, int32> IndexByName;
+
+	FRandomStream Random;
+
+	float TimeSinceLastSimulation = 0.f;
+
+	int32 BlockChangesNumber = 0;
+
+	int32 WokenUpNumber = 0;
+};
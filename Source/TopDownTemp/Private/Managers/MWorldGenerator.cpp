@@ -62,7 +62,8 @@ void AMWorldGenerator::InitSurroundingArea(const FIntPoint& PlayerBlock, const u
 			BlockMetadata->Biome = BiomeForInitialGeneration;
 		}
 	}
-	for (const auto BlockInRadius : BlocksInRadius)
+	// Neighbouring blocks go one after another, so the metadata and save data they share stay hot
+	for (const auto BlockInRadius : MGridAddressing::ToMortonArray(BlocksInRadius))
 	{
 		LoadOrGenerateBlock(BlockInRadius, false, ObserverIndex);
 	}
@@ -644,6 +645,53 @@ void AMWorldGenerator::OnTickGenerateBlocks()
 	}
 }
 
+void AMWorldGenerator::MarkBiomeChanged(const FIntPoint& BlockIndex)
+{
+	if (BlocksWithChangedBiome.IsEmpty())
+	{
+		// Blocks spawned during the same frame are resolved together
+		GetWorld()->GetTimerManager().SetTimerForNextTick([this]{ UpdateBiomeTransitions(); });
+	}
+	BlocksWithChangedBiome.Add(BlockIndex);
+}
+
+void AMWorldGenerator::UpdateBiomeTransitions()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMWorldGenerator::UpdateBiomeTransitions);
+
+	if (BlocksWithChangedBiome.IsEmpty())
+		return;
+
+	// A biome change affects the transitions of the block itself and the facing transitions of its neighbours
+	FMGridSet BlocksToUpdate;
+	BlocksToUpdate.Reserve(BlocksWithChangedBiome.Num() * 5);
+	for (const auto& BlockIndex : BlocksWithChangedBiome)
+	{
+		BlocksToUpdate.Add(BlockIndex);
+		for (const auto& Offset : AMGroundBlock::TransitionOffsets)
+		{
+			BlocksToUpdate.Add(BlockIndex + Offset);
+		}
+	}
+	BlocksWithChangedBiome.Empty();
+
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	for (const auto& BlockIndex : MGridAddressing::ToMortonArray(BlocksToUpdate))
+	{
+		const auto BlockMetadata = MetadataManager->FindBlock(BlockIndex);
+		if (!BlockMetadata || !IsValid(BlockMetadata->pGroundBlock))
+			continue;
+
+		for (const auto& Offset : AMGroundBlock::TransitionOffsets)
+		{
+			// Transitions are needed only between different biomes. A block that doesn't exist yet gets the default metadata, as it always did
+			const auto AdjacentBlockMetadata = MetadataManager->FindOrAddBlock(BlockIndex + Offset);
+			const bool bHidden = !AdjacentBlockMetadata || AdjacentBlockMetadata->Biome == BlockMetadata->Biome;
+			BlockMetadata->pGroundBlock->SetTransitionHidden(Offset, bHidden);
+		}
+	}
+}
+
 FVector AMWorldGenerator::GetGroundBlockSize() const
 {
 	if (const auto ToSpawnGroundBlock = ToSpawnActorClasses.Find(FName("GroundBlock")); GetWorld())
@@ -1019,7 +1067,7 @@ void AMWorldGenerator::RegenerateArea(const FVector& Location, int RadiusInBlock
 {
 	//TODO: Reuse CleanArea for this. Probably overload CleanArea() to take a TSet<FIntPoint>
 	const auto CenterBlock = GetGroundBlockIndex(Location);
-	for (const auto Block : GetBlocksInRadius(CenterBlock.X, CenterBlock.Y, RadiusInBlocks))
+	for (const auto Block : MGridAddressing::ToMortonArray(GetBlocksInRadius(CenterBlock.X, CenterBlock.Y, RadiusInBlocks)))
 	{
 		const auto BlockMetadata = AMGameMode::GetMetadataManager(this)->FindOrAddBlock(Block);
 		if (OverridePCGGraph)
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "MWorldGeneratorTypes.h"
+#include "MGridAddressing.h"
 #include "MWorldGenerator.generated.h"
 
 #define ECC_Pickable ECollisionChannel::ECC_GameTraceChannel2
@@ -98,6 +99,9 @@ public:
 
 	FIntPoint GetGroundBlockIndex(FVector Position) const;
 
+	/** Whether the block is within any observer's zone */
+	bool IsBlockActive(const FIntPoint& BlockIndex) const { return ActiveBlocksMap.Contains(BlockIndex); }
+
 	FVector GetGroundBlockLocation(FIntPoint BlockIndex);
 
 	/** Lists all the blocks lying on the perimeter of the circle with the given coordinates and radius */ //TODO: Use Bresenham's Circle Algorithm for better performance
@@ -112,6 +116,12 @@ public:
 
 	void SetupInputComponent();
 
+	/** Queues the block and its neighbours for UpdateBiomeTransitions(). The update runs once on the next tick */
+	void MarkBiomeChanged(const FIntPoint& BlockIndex);
+
+	/** Resolves transition visibility for all the blocks with changed biomes and their neighbours in one pass */
+	void UpdateBiomeTransitions();
+
 protected:
 
 	// TODO: Remove excess meta modifier
@@ -175,8 +185,11 @@ private: // Saved to memory
 
 private:
 
-	UPROPERTY()
-	TSet<FIntPoint> ActiveBlocksMap;
+	/** Blocks observed by at least one observer */
+	FMGridSet ActiveBlocksMap;
+
+	/** Blocks which biome changed since the last UpdateBiomeTransitions() */
+	FMGridSet BlocksWithChangedBiome;
 
 	UPROPERTY()
 	TMap<UClass*, FBoxSphereBounds> DefaultBoundsMap;
@@ -223,6 +223,50 @@ enum class EScreenPoint
 	TopRight
 };
 
+/** A straight piece of road projected on the ground. PCG content is not spawned closer than HalfWidth to it */
+USTRUCT(BlueprintType)
+struct FRoadCorridor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector2D Start = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector2D End = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float HalfWidth = 0.f;
+
+	bool IsPointWithin(const FVector2D& Point, float Margin = 0.f) const
+	{
+		const auto ClosestPoint = FMath::ClosestPointOnSegment2D(Point, Start, End);
+		return FVector2D::DistSquared(Point, ClosestPoint) <= FMath::Square(HalfWidth + Margin);
+	}
+};
+
+/** Compact description of what the PCG graph of a block produced. Used to check clients produce the same as the server */
+USTRUCT()
+struct FPCGGenerationResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 InstancesNumber = INDEX_NONE;
+
+	UPROPERTY()
+	int32 ActorsNumber = INDEX_NONE;
+
+	/** Order independent hash of the meshes/classes and rounded locations of all the instances and spawned actors */
+	UPROPERTY()
+	uint32 Checksum = 0;
+
+	bool IsSet() const { return InstancesNumber != INDEX_NONE; }
+
+	bool operator==(const FPCGGenerationResult& Other) const { return InstancesNumber == Other.InstancesNumber && ActorsNumber == Other.ActorsNumber && Checksum == Other.Checksum; }
+	bool operator!=(const FPCGGenerationResult& Other) const { return !(*this == Other); }
+};
+
 /** Struct for storing all PCG information for a block. E.g. Biome, Graph, amount of trees, bushes, etc.\n
  * Replicated. On replication triggers block generation for the owning block.\n
  * Is set/modified only once, right after the block is spawned on the Server.*/
@@ -240,4 +284,10 @@ struct FPCGVariables
 	int BushesCount = 0;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	int StonesCount = 0;
+	/** Derived from the block index by the server, so clients expand the graph into exactly the same content */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Seed = 0;
+	/** Roads crossing the block. Known before the block is populated, consumed by UMPCGRoadExclusionSettings */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FRoadCorridor> RoadCorridors;
 };
@@ -7,10 +7,12 @@
 #include "Managers/SaveManager/MSaveManager.h"
 #include "Managers/MWorldGenerator.h"
 #include "Algo/RandomShuffle.h"
+#include "Async/ParallelFor.h"
 #include "Components/SplineComponent.h"
 #include "Framework/MGameMode.h"
 #include "Kismet/GameplayStatics.h"
 #include "NavMesh/NavMeshBoundsVolume.h"
+#include "StationaryActors/MGroundBlock.h"
 #include "StationaryActors/MRoadSplineActor.h"
 #include "StationaryActors/Outposts/OutpostGenerators/MOutpostGenerator.h"
 #include "Components/BrushComponent.h"
@@ -120,36 +122,173 @@ void UMRoadManager::ConnectTwoBlocks(const FIntPoint& BlockA, const FIntPoint& B
 		return;
 	}
 	RoadSplineActor->SetRoadType(RoadType);
-	RoadSplineActor->GetSplineComponent()->RemoveSplinePoint(1, true);
 
-	int x_inc = FMath::Sign(BlockB.X - BlockA.X), y_inc = FMath::Sign(BlockB.Y - BlockA.Y);
+	FRoadCurveRequest Request;
+	Request.BlockA = BlockA;
+	Request.BlockB = BlockB;
+	Request.BlockSize = FVector2D(BlockSize);
+	Request.CurveFactor = CurveFactor;
+	Request.Seed = GetRoadSeed(BlockA, BlockB, RoadType);
 
-	int x = BlockA.X, y = BlockA.Y;
-	do
+	// Whatever blocking is already spawned on the way is respected by the curve
+	const FVector BlockMin(FMath::Min(BlockA.X, BlockB.X) * BlockSize.X, FMath::Min(BlockA.Y, BlockB.Y) * BlockSize.Y, 0.f);
+	const FVector BlockMax((FMath::Max(BlockA.X, BlockB.X) + 1) * BlockSize.X, (FMath::Max(BlockA.Y, BlockB.Y) + 1) * BlockSize.Y, 0.f);
+	for (const auto& [Name, Actor] : pWorldGenerator->GetActorsInRect(BlockMin, BlockMax, false))
+	{
+		if (!IsValid(Actor) || Actor->IsA(AMGroundBlock::StaticClass()) || !Actor->GetActorEnableCollision())
+			continue;
+
+		FVector Origin, BoxExtent;
+		Actor->GetActorBounds(true, Origin, BoxExtent);
+		Request.OccupiedAreas.Add(FBox2D(FVector2D(Origin - BoxExtent), FVector2D(Origin + BoxExtent)));
+	}
+
+	PendingRoads.Emplace(RoadSplineActor, MoveTemp(Request));
+
+	// Adds BlockB to BlockA's connections and vice versa.
+	AddConnection(BlockA, BlockB, RoadSplineActor);
+}
+
+void UMRoadManager::BuildPendingRoads()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMRoadManager::BuildPendingRoads);
+
+	if (PendingRoads.IsEmpty())
+		return;
+
+	// Curves only read plain data, so they are computed on worker threads. The spline actors are touched only on the game thread
+	auto& Build = RoadsBuilds.AddDefaulted_GetRef();
+	TArray<FRoadCurveRequest> Requests;
+	for (auto& [RoadSplineActor, Request] : PendingRoads)
+	{
+		Build.Roads.Add(RoadSplineActor);
+		Requests.Add(MoveTemp(Request));
+	}
+	PendingRoads.Empty();
+
+	Build.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Requests = MoveTemp(Requests)]
+	{
+		TArray<TArray<FVector>> RoadsPoints;
+		RoadsPoints.SetNum(Requests.Num());
+		ParallelFor(Requests.Num(), [&Requests, &RoadsPoints](int32 Index)
+		{
+			RoadsPoints[Index] = ComputeRoadCurve(Requests[Index]);
+		});
+		return RoadsPoints;
+	});
+
+	if (RoadsBuilds.Num() == 1)
+	{
+		pWorldGenerator->GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UMRoadManager::OnTickApplyBuiltRoads);
+	}
+}
+
+void UMRoadManager::ApplyBuiltRoads(bool bWait)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMRoadManager::ApplyBuiltRoads);
+
+	for (int32 BuildIndex = 0; BuildIndex < RoadsBuilds.Num();)
 	{
-		x = x == BlockB.X ? x : x + x_inc;
-		y = y == BlockB.Y ? y : y + y_inc;
-		FVector NewPosition{(x + 0.5f) * BlockSize.X, (y + 0.5f) * BlockSize.Y, 1.f}; // + 0.5f to put in the center of the block
-		if (x != BlockB.X || y != BlockB.Y)
+		auto& Build = RoadsBuilds[BuildIndex];
+		if (!bWait && !Build.Task.IsCompleted())
 		{
-			NewPosition.X += FMath::RandRange(-CurveFactor, CurveFactor) * BlockSize.X; // Random offset
-			NewPosition.Y += FMath::RandRange(-CurveFactor, CurveFactor) * BlockSize.Y; // Random offset
+			++BuildIndex;
+			continue;
 		}
-		RoadSplineActor->GetSplineComponent()->AddSplinePoint(NewPosition, ESplineCoordinateSpace::World, true);
-	} while (x != BlockB.X || y != BlockB.Y);
 
-	/** Set manually replicated point positions. Spline component doesn't replicate any of its properties. */
-	TArray<FVector> PointsForReplication;
-	const int32 PointsCount = RoadSplineActor->GetSplineComponent()->GetNumberOfSplinePoints();
-	for (int32 i = 0; i < PointsCount; ++i)
+		const auto& RoadsPoints = Build.Task.GetResult();
+		for (int32 i = 0; i < Build.Roads.Num(); ++i)
+		{
+			const auto RoadSplineActor = Build.Roads[i].Get();
+			if (!RoadSplineActor)
+				continue;
+
+			// Spline is updated once for the whole road instead of once per point
+			RoadSplineActor->GetSplineComponent()->SetSplinePoints(RoadsPoints[i], ESplineCoordinateSpace::World, true);
+			RoadSplineActor->SetPointsForReplication(RoadsPoints[i]);
+
+			AddRoadCorridors(RoadSplineActor);
+		}
+		RoadsBuilds.RemoveAt(BuildIndex);
+	}
+
+	RegenerateBlocksCrossedByRoads();
+}
+
+void UMRoadManager::OnTickApplyBuiltRoads()
+{
+	ApplyBuiltRoads();
+
+	if (!RoadsBuilds.IsEmpty())
 	{
-		FVector PointLocation = RoadSplineActor->GetSplineComponent()->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-		PointsForReplication.Add(PointLocation);
+		pWorldGenerator->GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UMRoadManager::OnTickApplyBuiltRoads);
 	}
-	RoadSplineActor->SetPointsForReplication(PointsForReplication);
+}
 
-	// Adds BlockB to BlockA's connections and vice versa.
-	AddConnection(BlockA, BlockB, RoadSplineActor);
+TArray<FVector> UMRoadManager::ComputeRoadCurve(const FRoadCurveRequest& Request)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMRoadManager::ComputeRoadCurve);
+
+	TArray<FVector> Points;
+	if (Request.BlockA == Request.BlockB)
+	{
+		check(false);
+		return Points;
+	}
+
+	const auto GetBlockCenter = [&Request](int X, int Y)
+	{
+		return FVector2D((X + 0.5f) * Request.BlockSize.X, (Y + 0.5f) * Request.BlockSize.Y); // + 0.5f to put in the center of the block
+	};
+	const auto IsOccupied = [&Request](const FVector2D& Location)
+	{
+		return Request.OccupiedAreas.ContainsByPredicate([&Location](const FBox2D& Area) { return Area.IsInside(Location); });
+	};
+
+	// Noise makes neighbouring points lean the same way, so the road meanders instead of zigzagging
+	FRandomStream RandomStream(Request.Seed);
+	const float NoiseOffsetX = RandomStream.FRandRange(0.f, 1024.f);
+	const float NoiseOffsetY = RandomStream.FRandRange(0.f, 1024.f);
+
+	const int x_inc = FMath::Sign(Request.BlockB.X - Request.BlockA.X), y_inc = FMath::Sign(Request.BlockB.Y - Request.BlockA.Y);
+	Points.Reserve(FMath::Max(FMath::Abs(Request.BlockB.X - Request.BlockA.X), FMath::Abs(Request.BlockB.Y - Request.BlockA.Y)) + 1);
+	Points.Add(FVector(GetBlockCenter(Request.BlockA.X, Request.BlockA.Y), 1.f));
+
+	int x = Request.BlockA.X, y = Request.BlockA.Y;
+	int PointIndex = 0;
+	do
+	{
+		x = x == Request.BlockB.X ? x : x + x_inc;
+		y = y == Request.BlockB.Y ? y : y + y_inc;
+		++PointIndex;
+		const auto BlockCenter = GetBlockCenter(x, y);
+		FVector2D NewPosition = BlockCenter;
+		if (x != Request.BlockB.X || y != Request.BlockB.Y)
+		{
+			const FVector2D Offset(
+				FMath::PerlinNoise1D(NoiseOffsetX + PointIndex * Request.NoiseFrequency) * Request.CurveFactor * Request.BlockSize.X,
+				FMath::PerlinNoise1D(NoiseOffsetY + PointIndex * Request.NoiseFrequency) * Request.CurveFactor * Request.BlockSize.Y);
+
+			// Pull the point towards the block center until it's free. The center itself is used if nothing else fits
+			NewPosition = BlockCenter + Offset;
+			for (int Attempt = 0; Attempt < 3 && IsOccupied(NewPosition); ++Attempt)
+			{
+				NewPosition = BlockCenter + Offset * (0.5f / (1 << Attempt));
+			}
+			if (IsOccupied(NewPosition))
+			{
+				NewPosition = BlockCenter;
+			}
+		}
+		Points.Add(FVector(NewPosition, 1.f));
+	} while (x != Request.BlockB.X || y != Request.BlockB.Y);
+
+	return Points;
+}
+
+int32 UMRoadManager::GetRoadSeed(const FIntPoint& BlockA, const FIntPoint& BlockB, const ERoadType RoadType)
+{
+	return static_cast<int32>(HashCombine(HashCombine(MGridAddressing::HashKey(BlockA), MGridAddressing::HashKey(BlockB)), static_cast<uint32>(RoadType)));
 }
 
 const TSet<FIntPoint> UMRoadManager::GetAdjacentRegions(const FIntPoint& ChunkIndex) const
@@ -387,6 +526,93 @@ FRoadActorMapWrapper UMRoadManager::GetConnections(const FIntPoint& Block, ERoad
 	return {};
 }
 
+void UMRoadManager::AddRoadCorridors(const AMRoadSplineActor* RoadActor)
+{
+	const auto* SplineComponent = RoadActor ? RoadActor->GetSplineComponent() : nullptr;
+	if (!SplineComponent)
+	{
+		check(false);
+		return;
+	}
+
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	if (!MetadataManager) { check(false); return; }
+
+	const auto* pHalfWidth = CorridorHalfWidths.Find(RoadActor->GetRoadType());
+	const float HalfWidth = pHalfWidth ? *pHalfWidth : 0.f;
+
+	// Approximate the curve with straight pieces short enough to keep the corridor close to the actual spline
+	const auto BlockSize = pWorldGenerator->GetGroundBlockSize();
+	const float PieceLength = FMath::Max(CorridorPieceLength * FMath::Min(BlockSize.X, BlockSize.Y), 1.f);
+	const float SplineLength = SplineComponent->GetSplineLength();
+	const int PiecesNumber = FMath::Max(FMath::CeilToInt(SplineLength / PieceLength), 1);
+
+	FVector2D PieceStart(SplineComponent->GetLocationAtDistanceAlongSpline(0.f, ESplineCoordinateSpace::World));
+	for (int i = 1; i <= PiecesNumber; ++i)
+	{
+		const FVector2D PieceEnd(SplineComponent->GetLocationAtDistanceAlongSpline(SplineLength * i / PiecesNumber, ESplineCoordinateSpace::World));
+		FRoadCorridor Corridor;
+		Corridor.Start = PieceStart;
+		Corridor.End = PieceEnd;
+		Corridor.HalfWidth = HalfWidth;
+
+		// Every block touched by the bounding box of the piece gets it
+		const FVector2D Extent(HalfWidth, HalfWidth);
+		const auto MinBlock = pWorldGenerator->GetGroundBlockIndex(FVector(FVector2D::Min(PieceStart, PieceEnd) - Extent, 0.f));
+		const auto MaxBlock = pWorldGenerator->GetGroundBlockIndex(FVector(FVector2D::Max(PieceStart, PieceEnd) + Extent, 0.f));
+		for (int X = MinBlock.X; X <= MaxBlock.X; ++X)
+		{
+			for (int Y = MinBlock.Y; Y <= MaxBlock.Y; ++Y)
+			{
+				RoadCorridors.FindOrAdd({X, Y}).Add(Corridor);
+
+				if (const auto BlockMetadata = MetadataManager->FindBlock({X, Y});
+					BlockMetadata && BlockMetadata->pGroundBlock && (!BlockBeingPrepared.IsSet() || *BlockBeingPrepared != FIntPoint(X, Y)))
+				{
+					BlocksToRegenerate.Add({X, Y});
+				}
+			}
+		}
+
+		PieceStart = PieceEnd;
+	}
+}
+
+void UMRoadManager::RegenerateBlocksCrossedByRoads()
+{
+	// Regenerating may prepare the roads of other regions, which may mark more blocks
+	const auto Blocks = MoveTemp(BlocksToRegenerate);
+	BlocksToRegenerate.Reset();
+	for (const auto& BlockIndex : Blocks)
+	{
+		pWorldGenerator->RegenerateBlock(BlockIndex);
+	}
+}
+
+void UMRoadManager::PrepareRoadsForBlock(const FIntPoint& BlockIndex)
+{
+	TGuardValue<TOptional<FIntPoint>> BlockBeingPreparedGuard(BlockBeingPrepared, BlockIndex);
+
+	// Usually the region is already processed because observers enter regions before they see their blocks
+	const auto RegionIndex = GetRegionIndexByChunk(GetChunkIndexByBlock(BlockIndex));
+	if (const auto* RegionMetadata = GridOfRegions.Find(RegionIndex); !RegionMetadata || !RegionMetadata->bProcessed)
+	{
+		LoadOrGenerateRegion(RegionIndex);
+
+		// The block is populated right after, it can't wait for the roads of its region to be built on a later frame
+		ApplyBuiltRoads(true);
+	}
+}
+
+TArray<FRoadCorridor> UMRoadManager::GetRoadCorridors(const FIntPoint& BlockIndex) const
+{
+	if (const auto* BlockCorridors = RoadCorridors.Find(BlockIndex))
+	{
+		return *BlockCorridors;
+	}
+	return {};
+}
+
 void UMRoadManager::TriggerOutpostGenerationForAdjacentChunks(const FIntPoint& CurrentChunk)
 {
 	for (int x = -1; x <= 1; ++x)
@@ -408,6 +634,7 @@ void UMRoadManager::LoadOrGenerateRegion(const FIntPoint& RegionIndex)
 	{
 		GenerateConnectionsBetweenChunksWithinRegion(RegionIndex);
 	}
+	BuildPendingRoads();
 }
 
 void UMRoadManager::GenerateConnectionsBetweenChunksWithinRegion(const FIntPoint& RegionIndex)
@@ -535,8 +762,7 @@ FIntPoint UMRoadManager::GetChunkIndexByLocation(const FVector& Location) const
 
 FIntPoint UMRoadManager::GetChunkIndexByBlock(const FIntPoint& BlockIndex) const
 {
-	return FIntPoint(FMath::FloorToInt(static_cast<float>(BlockIndex.X) / ChunkSize.X),
-					FMath::FloorToInt(static_cast<float>(BlockIndex.Y) / ChunkSize.Y));
+	return MGridAddressing::GetParentIndex(BlockIndex, ChunkSize);
 }
 
 FIntPoint UMRoadManager::GetChunkCenterBlock(const FIntPoint& ChunkIndex) const
@@ -547,8 +773,7 @@ FIntPoint UMRoadManager::GetChunkCenterBlock(const FIntPoint& ChunkIndex) const
 
 FIntPoint UMRoadManager::GetRegionIndexByChunk(const FIntPoint& ChunkIndex) const
 {
-	return FIntPoint(FMath::FloorToInt(static_cast<float>(ChunkIndex.X) / RegionSize.X),
-					FMath::FloorToInt(static_cast<float>(ChunkIndex.Y) / RegionSize.Y));
+	return MGridAddressing::GetParentIndex(ChunkIndex, RegionSize);
 }
 
 AMOutpostGenerator* UMRoadManager::GetOutpostGenerator(const FIntPoint& ChunkIndex)
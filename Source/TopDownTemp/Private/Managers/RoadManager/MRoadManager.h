@@ -2,8 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "MRoadManagerTypes.h"
+#include "Managers/MWorldGeneratorTypes.h"
+#include "Managers/MGridAddressing.h"
 #include "Math/UnrealMathUtility.h"
 #include "Helpers/MGroundMarker.h"
+#include "Tasks/Task.h"
 #include "MRoadManager.generated.h"
 
 class UMRoadMap;
@@ -13,6 +16,15 @@ class AMWorldGenerator;
 class AMOutpostGenerator;
 class ANavMeshBoundsVolume;
 
+/** Roads whose points are being computed on worker threads */
+struct FRoadsBuild
+{
+	TArray<TWeakObjectPtr<AMRoadSplineActor>> Roads;
+
+	/** Points of every road, in the order of Roads */
+	UE::Tasks::TTask<TArray<TArray<FVector>>> Task;
+};
+
 /** Class responsible for road generation within Regions, their Chunks and their blocks.\n\n
  *  Handles spawn of Outposts such as villages/camps/sites.\n\n
  *  Responsible for in-game navigation, direction signs, etc. */
@@ -26,8 +38,24 @@ public:
 
 	void ConnectTwoChunks(FIntPoint ChunkA, FIntPoint ChunkB, const ERoadType RoadType = ERoadType::MainRoad);
 
+	/** Spawns the road actor and registers the connection right away.\n
+	 * The points are computed later on worker threads, see BuildPendingRoads() */
 	void ConnectTwoBlocks(const FIntPoint& BlockA, const FIntPoint& BlockB, const ERoadType RoadType = ERoadType::Trail);
 
+	/** Launches the computation of all the roads connected since the last call.\n
+	 * The points are applied to the spline actors on a later frame, see ApplyBuiltRoads() */
+	void BuildPendingRoads();
+
+	/** Applies the points of the finished builds to the spline actors and adds their corridors.\n
+	 * bWait blocks until every build is finished, for when the roads are needed right away */
+	void ApplyBuiltRoads(bool bWait = false);
+
+	/** Pure function, the same request always gives the same points. Safe to call from any thread */
+	static TArray<FVector> ComputeRoadCurve(const FRoadCurveRequest& Request);
+
+	/** Depends only on the connection, not on the order the roads are connected in */
+	static int32 GetRoadSeed(const FIntPoint& BlockA, const FIntPoint& BlockB, const ERoadType RoadType);
+
 	const TSet<FIntPoint> GetAdjacentRegions(const FIntPoint& ChunkIndex) const;
 
 	/** Set the observer flag for the current region and all adjacent regions to the chunk.
@@ -60,14 +88,14 @@ public:
 
 	FIntPoint GetChunkIndexByBlock(const FIntPoint& BlockIndex) const;
 
-	FIntPoint GetBlockIndexByChunk(const FIntPoint& ChunkIndex) const { return ChunkIndex * ChunkSize; }
+	FIntPoint GetBlockIndexByChunk(const FIntPoint& ChunkIndex) const { return MGridAddressing::GetFirstChildIndex(ChunkIndex, ChunkSize); }
 
 	/** Returns the index of the block closest to the center of this chunk (rounded down) */
 	FIntPoint GetChunkCenterBlock(const FIntPoint& ChunkIndex) const;
 
 	FIntPoint GetRegionIndexByChunk(const FIntPoint& ChunkIndex) const;
 
-	FIntPoint GetChunkIndexByRegion(const FIntPoint& RegionIndex) const { return RegionIndex * RegionSize; }
+	FIntPoint GetChunkIndexByRegion(const FIntPoint& RegionIndex) const { return MGridAddressing::GetFirstChildIndex(RegionIndex, RegionSize); }
 
 	/** Get the chunk's outpost. If the chunk has no outpost generated, return nullptr */
 	UFUNCTION()
@@ -78,6 +106,13 @@ public:
 
 	const TMap<FName, TSubclassOf<AActor>>& GetOutpostBPClasses() const { return OutpostBPClasses; }
 
+	/** Makes sure the roads of the block's region exist, so they can be excluded when the block is populated.\n
+	 * Roads of other regions that are still being built are applied later, and the blocks they cross are regenerated then */
+	void PrepareRoadsForBlock(const FIntPoint& BlockIndex);
+
+	/** Road pieces crossing the block. Empty if there are no roads */
+	TArray<FRoadCorridor> GetRoadCorridors(const FIntPoint& BlockIndex) const;
+
 	void SaveToMemory();
 
 public: // For debugging
@@ -97,6 +132,13 @@ protected: // Road connections
 	/** Finds all blocks connected to a given one. */
 	FRoadActorMapWrapper GetConnections(const FIntPoint& Block, ERoadType RoadType);
 
+	/** Splits the road into straight corridors and matches them with every block they cross.\n
+	 * Blocks that were already populated get their content on the road, so they are marked for regeneration */
+	void AddRoadCorridors(const AMRoadSplineActor* RoadActor);
+
+	/** Populates again the blocks marked by AddRoadCorridors(), this time with the corridors excluded */
+	void RegenerateBlocksCrossedByRoads();
+
 protected:
 	/** If adjacent chunks have outpost generators, call their Generate() to spawn their actors */
 	void TriggerOutpostGenerationForAdjacentChunks(const FIntPoint& CurrentChunk);
@@ -135,6 +177,14 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category="MRoadManager|Configuration", meta=(ClampMin="0.1", ClampMax="0.5"))
 	float CurveFactor = 0.35f;
 
+	/** Half of the area along a road that is kept free of PCG content */
+	UPROPERTY(EditDefaultsOnly, Category="MRoadManager|Configuration")
+	TMap<ERoadType, float> CorridorHalfWidths = { { ERoadType::MainRoad, 200.f }, { ERoadType::Trail, 100.f } };
+
+	/** Length of one straight corridor piece, in fractions of the block size */
+	UPROPERTY(EditDefaultsOnly, Category="MRoadManager|Configuration", meta=(ClampMin="0.05", ClampMax="1"))
+	float CorridorPieceLength = 0.25f;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TMap<FName, TSubclassOf<AActor>> OutpostBPClasses;
 
@@ -152,6 +202,23 @@ private:
 	/** Filled in only to create new ones or load existing ones needed for the current session. */
 	UPROPERTY()
 	TMap<FIntPoint, FRegionMetadata> GridOfRegions;
+
+	/** Roads that are spawned and connected but have no points yet */
+	TArray<TPair<TWeakObjectPtr<AMRoadSplineActor>, FRoadCurveRequest>> PendingRoads;
+
+	/** Launched by BuildPendingRoads() and not applied yet */
+	TArray<FRoadsBuild> RoadsBuilds;
+
+	void OnTickApplyBuiltRoads();
+
+	/** Road corridors per block. Not saved, rebuilt along with the road actors */
+	TMGridMap<TArray<FRoadCorridor>> RoadCorridors;
+
+	/** Blocks populated before a corridor crossing them was known */
+	TSet<FIntPoint> BlocksToRegenerate;
+
+	/** The block PrepareRoadsForBlock() was called for. It's about to be populated, so it doesn't need a regeneration */
+	TOptional<FIntPoint> BlockBeingPrepared;
 	
 	UPROPERTY()
 	URoadManagerSave* LoadedSave;
@@ -47,6 +47,25 @@ enum class ERoadType : uint8
 };
 ENUM_RANGE_BY_COUNT(ERoadType, ERoadType::Count);
 
+/** Everything needed to build the points of a road between two blocks. Plain data, so it can be processed on any thread */
+struct FRoadCurveRequest
+{
+	FIntPoint BlockA = FIntPoint::ZeroValue;
+	FIntPoint BlockB = FIntPoint::ZeroValue;
+	FVector2D BlockSize = FVector2D::ZeroVector;
+
+	/** Max offset of a point from its block center, in fractions of the block size */
+	float CurveFactor = 0.f;
+
+	/** How fast the meander changes from point to point */
+	float NoiseFrequency = 0.37f;
+
+	int32 Seed = 0;
+
+	/** Points are moved towards the block center until they leave these areas */
+	TArray<FBox2D> OccupiedAreas;
+};
+
 USTRUCT()
 struct FChunkMetadata // TODO: Consider converting to a class
 {
@@ -51,10 +51,8 @@ struct FActorSaveData
 	TMap<FName, bool> MiscBool;
 };
 
-// TODO: If FMActorSaveData and FMCharacterSaveData share too much in common, add a common base class
-
 USTRUCT()
-struct FMActorSaveData
+struct FMCharacterSaveData
 {
 	GENERATED_USTRUCT_BODY()
 
@@ -62,21 +60,23 @@ struct FMActorSaveData
 	FActorSaveData ActorSaveData;
 
 	UPROPERTY()
-	int AppearanceID;
+	FName SpeciesName;
 
 	UPROPERTY()
-	bool IsRandomizedAppearance;
+	float Health;
 
 	UPROPERTY()
 	TArray<FItem> InventoryContents;
 
-	/** Stores Uid for any actor this is depending on. House would store its outpost, etc. */
+	/** Uid of the house where this character resides. MIN_int32 means not assigned */
 	UPROPERTY()
-	TMap<FName, FMUid> DependenciesUid;
+	FMUid HouseUid;
 };
 
+// TODO: If FMActorSaveData and FMCharacterSaveData share too much in common, add a common base class
+
 USTRUCT()
-struct FMCharacterSaveData
+struct FMActorSaveData
 {
 	GENERATED_USTRUCT_BODY()
 
@@ -84,17 +84,21 @@ struct FMCharacterSaveData
 	FActorSaveData ActorSaveData;
 
 	UPROPERTY()
-	FName SpeciesName;
+	int AppearanceID;
 
 	UPROPERTY()
-	float Health;
+	bool IsRandomizedAppearance;
 
 	UPROPERTY()
 	TArray<FItem> InventoryContents;
 
-	/** Uid of the house where this character resides. MIN_int32 means not assigned */
+	/** Stores Uid for any actor this is depending on. House would store its outpost, etc. */
 	UPROPERTY()
-	FMUid HouseUid;
+	TMap<FName, FMUid> DependenciesUid;
+
+	/** Residents of a house that are not materialized into characters. See AMOutpostHouse */
+	UPROPERTY()
+	TArray<FMCharacterSaveData> VirtualResidents;
 };
 
 USTRUCT()
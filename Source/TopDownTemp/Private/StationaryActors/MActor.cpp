@@ -83,8 +83,6 @@ void AMActor::PostInitializeComponents()
 	{
 		FaceCameraComponent->PostInitChildren();
 	}
-
-	CreateDynamicMaterials();
 }
 
 void AMActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -96,6 +94,9 @@ void AMActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeP
 
 void AMActor::CreateDynamicMaterials()
 {
+	if (!DynamicMaterials.IsEmpty())
+		return;
+
 	TArray<UStaticMeshComponent*> StaticMeshComps;
 	GetComponents<UStaticMeshComponent>(StaticMeshComps);
 	for (const auto StaticMeshComp : StaticMeshComps)
@@ -111,6 +112,25 @@ void AMActor::CreateDynamicMaterials()
 	}
 }
 
+void AMActor::RestoreSharedMaterials()
+{
+	for (const auto& [StaticMeshComp, DynamicMaterialArrayWrapper] : DynamicMaterials)
+	{
+		if (!IsValid(StaticMeshComp))
+			continue;
+
+		const auto& Materials = DynamicMaterialArrayWrapper.ArrayMaterialInstanceDynamic;
+		for (int i = 0; i < Materials.Num(); ++i)
+		{
+			if (Materials[i])
+			{
+				StaticMeshComp->SetMaterial(i, Materials[i]->Parent);
+			}
+		}
+	}
+	DynamicMaterials.Empty();
+}
+
 EBiome AMActor::GetMyBiome()
 {
 	if (const auto WorldGenerator = AMGameMode::GetWorldGenerator(this))
@@ -31,6 +31,8 @@ public: // Have effect only when called under FOnSpawnActorStarted
 	UFUNCTION(BlueprintCallable)
 	void SetAppearanceID(int IN_AppearanceID) { AppearanceID = IN_AppearanceID; }
 
+	void SetIsRandomizedAppearance(bool Value) { IsRandomizedAppearance = Value; }
+
 public:
 	/** Use AMWorldGenerator::RemoveFromGrid instead */
 	//bool Destroy(bool bNetForce = false, bool bShouldModifyLevel = true ) = delete;
@@ -46,18 +48,30 @@ public:
 
 	int GetAppearanceID() const { return AppearanceID; }
 	bool GetIsRandomizedAppearance() const { return IsRandomizedAppearance; }
+	bool GetCanBeInstanced() const { return bCanBeInstanced; }
 
 	void SetUid(const FMUid& _Uid) { Uid = _Uid; }
 
 	UFUNCTION(BlueprintCallable)
 	void InitialiseInventory(const TArray<struct FItem>& IN_Items);
 
+	/** Returns an empty map unless the actor is currently being faded by occlusion.\n
+	 * Dynamic materials are no longer created in BeginPlay. Call CreateDynamicMaterials() first if you need them,
+	 * note that the occlusion fade restores the shared materials once it's done */
 	UFUNCTION(BlueprintCallable)
 	const TMap<UStaticMeshComponent*, FArrayMaterialInstanceDynamicWrapper>& GetDynamicMaterials() const
 	{
 		return DynamicMaterials;
 	}
 
+	/** Each material is replaced by its dynamic version in order to be modified at runtime as needed.\n
+	 * Dynamic materials break batching with other actors, so they exist only while needed. Does nothing if already created */
+	UFUNCTION(BlueprintCallable)
+	void CreateDynamicMaterials();
+
+	/** Puts the shared materials back and drops the dynamic ones */
+	void RestoreSharedMaterials();
+
 	/** Start from the base and compose structs upwards (FActorSaveData -> might add more in between -> FMActorSaveData).\n
 	 * Must always call Super::GetSaveData(). */
 	virtual FMActorSaveData GetSaveData() const;
@@ -76,9 +90,6 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void ApplyAppearanceID();
 
-	/** Each material is replaced by its dynamic version in order to be modified at runtime as needed */
-	void CreateDynamicMaterials();
-
 	UFUNCTION(BlueprintCallable)
 	EBiome GetMyBiome();
 
@@ -111,6 +122,13 @@ protected:
 	UPROPERTY(BlueprintReadOnly)
 	int AppearanceID = 0;
 
+	/** Purely decorative content spawned by PCG. The ground block renders it as instances and spawns the actor back
+	 * only when gameplay needs it. See AMGroundBlock::PromoteInstance.\n
+	 * No native class is decorative on its own, so it's off by default and must be ticked in the defaults of
+	 * BP_3DTree, BP_3DBush and the BigFlowers blueprints (BP_Chamomile, BP_Fern, BP_Poppy, BP_Yarrow) */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bCanBeInstanced = false;
+
 	UPROPERTY()
 	TMap<UStaticMeshComponent*, FArrayMaterialInstanceDynamicWrapper> DynamicMaterials;
 };
\ No newline at end of file
@@ -4,13 +4,20 @@
 #include "MGroundBlock.h"
 
 #include "PaperSpriteComponent.h"
+#include "TopDownTemp.h"
+#include "Algo/Count.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "PCGComponent.h"
 #include "PCGGraph.h"
 #include "Net/UnrealNetwork.h"
 #include "Framework/MGameMode.h"
+#include "Managers/MBlockGenerator.h"
 #include "Managers/MMetadataManager.h"
 #include "Managers/MWorldGenerator.h"
 
+const FIntPoint AMGroundBlock::TransitionOffsets[4] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
 AMGroundBlock::AMGroundBlock(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	GroundMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("GroundMesh"));
@@ -37,37 +44,36 @@ void AMGroundBlock::UpdateBiome(EBiome IN_Biome)
 	{
 		return; // Prevents endless loop
 	}
-	// Get the grid of actors to access adjacent blocks (for possible disabling of their transitions)
 	if (const auto WorldGenerator = AMGameMode::GetWorldGenerator(this))
 	{
-		const FIntPoint MyIndex = WorldGenerator->GetGroundBlockIndex(GetActorLocation());
-
-		// Disable transitions if they contact with the same biome or the adjacent block doesn't even exist
-		TArray<FIntPoint> AdjacentBlockOffsets{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}; // Left; Right; Top; Bottom
-		for (const auto& AdjacentBlockOffset : AdjacentBlockOffsets)
-		{
-			const auto Block = AMGameMode::GetMetadataManager(this)->FindOrAddBlock({ MyIndex.X + AdjacentBlockOffset.X, MyIndex.Y + AdjacentBlockOffset.Y });
-			if (!Block || Block->Biome == IN_Biome)
-			{
-				if (const auto Transition = GetTransitionByOffset(AdjacentBlockOffset))
-					Transition->SetHiddenInGame(true);
-			}
-			else if (Block->pGroundBlock)
-			{
-				Block->pGroundBlock->UpdateTransition(AdjacentBlockOffset * -1, IN_Biome); // *-1 because we update the opposite side of the adjacent block
-			}
-		}
+		WorldGenerator->MarkBiomeChanged(WorldGenerator->GetGroundBlockIndex(GetActorLocation()));
 	}
 	//TODO: Consider hiding lower block transitions
 
 	OnBiomeUpdated();
 }
 
-void AMGroundBlock::UpdateTransition(FIntPoint Offset, EBiome AdjacentBiome)
+void AMGroundBlock::SetTransitionHidden(const FIntPoint& Offset, bool bHidden)
 {
-	if (const auto Transition = GetTransitionByOffset(Offset))
+	if (const auto Transition = GetTransitionByOffset(Offset); Transition && Transition->bHiddenInGame != bHidden)
 	{
-		Transition->SetHiddenInGame(GetMyBiome() == AdjacentBiome);
+		Transition->SetHiddenInGame(bHidden);
+	}
+}
+
+bool AMGroundBlock::IsTransitionHidden(const FIntPoint& Offset) const
+{
+	const auto Transition = GetTransitionByOffset(Offset);
+	return !Transition || Transition->bHiddenInGame;
+}
+
+void AMGroundBlock::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (const auto PCGComponent = GetComponentByClass<UPCGComponent>())
+	{
+		PCGComponent->OnPCGGraphGeneratedExternal.AddDynamic(this, &AMGroundBlock::OnPCGGenerated);
 	}
 }
 
@@ -76,6 +82,7 @@ void AMGroundBlock::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(AMGroundBlock, PCGVariables);
+	DOREPLIFETIME(AMGroundBlock, ServerPCGResult);
 }
 
 UStaticMeshComponent* AMGroundBlock::GetTransitionByOffset(FIntPoint Offset) const
@@ -106,7 +113,338 @@ void AMGroundBlock::OnPCGVariablesReplicated()
 	{
 		check(PCGVariables.Graph);
 		PCGComponent->SetGraph(PCGVariables.Graph.Get());
+		// Clients expand the graph on their own from the replicated seed and counts, that is much cheaper for the network
+		// than replicating every generated point. CheckPCGDeterminism() verifies they get exactly what the server got
+		PCGComponent->Seed = PCGVariables.Seed;
 		PCGComponent->GenerateLocal(false);
 	}
 	OnBiomeUpdated();
 }
+
+FPCGGenerationResult AMGroundBlock::ComputePCGResult() const
+{
+	FPCGGenerationResult Result;
+	Result.InstancesNumber = 0;
+	Result.ActorsNumber = 0;
+
+	// Rounded, so tiny float differences between platforms don't count
+	const auto HashLocation = [](const FVector& Location) { return GetTypeHash(FIntVector(Location)); };
+
+	TArray<UInstancedStaticMeshComponent*> InstancedComps;
+	GetComponents<UInstancedStaticMeshComponent>(InstancedComps);
+	for (const auto InstancedComp : InstancedComps)
+	{
+		// Made of the collapsed actors, not by the graph
+		if (InstancedBatches.Contains(InstancedComp))
+			continue;
+
+		const uint32 MeshHash = GetTypeHash(InstancedComp->GetStaticMesh() ? InstancedComp->GetStaticMesh()->GetFName() : NAME_None);
+		for (int32 i = 0; i < InstancedComp->GetInstanceCount(); ++i)
+		{
+			FTransform InstanceTransform;
+			InstancedComp->GetInstanceTransform(i, InstanceTransform, true);
+			// Sum doesn't depend on the order of components and instances
+			Result.Checksum += HashCombine(MeshHash, HashLocation(InstanceTransform.GetLocation()));
+		}
+		Result.InstancesNumber += InstancedComp->GetInstanceCount();
+	}
+
+	TArray<AActor*> AttachedActors;
+	GetAttachedActors(AttachedActors);
+	for (const auto Actor : AttachedActors)
+	{
+		// Actors replicated from the server are not a part of the local generation
+		if (!IsValid(Actor) || !Actor->HasAuthority())
+			continue;
+
+		Result.Checksum += HashCombine(GetTypeHash(Actor->GetClass()->GetFName()), HashLocation(Actor->GetActorLocation()));
+		++Result.ActorsNumber;
+	}
+	return Result;
+}
+
+void AMGroundBlock::OnPCGGenerated(UPCGComponent* PCGComponent)
+{
+	if (HasAuthority())
+	{
+		ServerPCGResult = ComputePCGResult();
+		CheckRoadsExcluded();
+	}
+	else
+	{
+		LocalPCGResult = ComputePCGResult();
+		CheckPCGDeterminism();
+	}
+	// After the result, so it describes what the graph produced
+	CollapseDecorativeActors();
+}
+
+void AMGroundBlock::OnPCGResultReplicated()
+{
+	CheckPCGDeterminism();
+}
+
+void AMGroundBlock::CheckPCGDeterminism() const
+{
+	if (!ServerPCGResult.IsSet() || !LocalPCGResult.IsSet())
+		return;
+
+	if (ServerPCGResult != LocalPCGResult)
+	{
+		UE_LOG(LogTopDownTemp, Error, TEXT("%s generated %d instances and %d actors (checksum %u) while the server generated %d and %d (checksum %u). Check the graph for non seeded randomness"),
+			*GetName(), LocalPCGResult.InstancesNumber, LocalPCGResult.ActorsNumber, LocalPCGResult.Checksum,
+			ServerPCGResult.InstancesNumber, ServerPCGResult.ActorsNumber, ServerPCGResult.Checksum);
+	}
+}
+
+void AMGroundBlock::CheckRoadsExcluded() const
+{
+	if (PCGVariables.RoadCorridors.IsEmpty() || !UMBlockGenerator::HasRoadExclusion(PCGVariables.Graph.Get()))
+		return;
+
+	const auto IsOnRoad = [this](const FVector& Location)
+	{
+		return PCGVariables.RoadCorridors.ContainsByPredicate([Location = FVector2D(Location)](const FRoadCorridor& Corridor) { return Corridor.IsPointWithin(Location); });
+	};
+
+	int OnRoadNumber = 0;
+	TArray<UInstancedStaticMeshComponent*> InstancedComps;
+	GetComponents<UInstancedStaticMeshComponent>(InstancedComps);
+	for (const auto InstancedComp : InstancedComps)
+	{
+		if (InstancedBatches.Contains(InstancedComp))
+			continue;
+
+		for (int32 i = 0; i < InstancedComp->GetInstanceCount(); ++i)
+		{
+			FTransform InstanceTransform;
+			InstancedComp->GetInstanceTransform(i, InstanceTransform, true);
+			OnRoadNumber += IsOnRoad(InstanceTransform.GetLocation()) ? 1 : 0;
+		}
+	}
+
+	TArray<AActor*> AttachedActors;
+	GetAttachedActors(AttachedActors);
+	for (const auto Actor : AttachedActors)
+	{
+		OnRoadNumber += IsValid(Actor) && IsOnRoad(Actor->GetActorLocation()) ? 1 : 0;
+	}
+
+	ensureMsgf(OnRoadNumber == 0, TEXT("%s has %d instances and actors on the road after generation"), *GetName(), OnRoadNumber);
+}
+
+void AMGroundBlock::CollapseDecorativeActors()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMGroundBlock::CollapseDecorativeActors);
+
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+
+	TArray<AActor*> AttachedActors;
+	GetAttachedActors(AttachedActors);
+	for (const auto Actor : AttachedActors)
+	{
+		const auto MActor = Cast<AMActor>(Actor);
+		if (!MActor || !MActor->GetCanBeInstanced())
+			continue;
+		if (MetadataManager && MetadataManager->Find(FName(MActor->GetName())))
+			continue; // Enrolled to the grid, so gameplay relies on it
+
+		const int32 RecordIndex = InstancedActors.AddDefaulted();
+		auto& Record = InstancedActors[RecordIndex];
+		Record.Class = MActor->GetClass();
+		Record.Transform = MActor->GetActorTransform();
+		Record.AppearanceID = MActor->GetAppearanceID();
+
+		TArray<UStaticMeshComponent*> StaticMeshComps;
+		MActor->GetComponents<UStaticMeshComponent>(StaticMeshComps);
+		for (const auto StaticMeshComp : StaticMeshComps)
+		{
+			if (!StaticMeshComp->GetStaticMesh() || !StaticMeshComp->IsVisible() || StaticMeshComp->IsA<UInstancedStaticMeshComponent>())
+				continue;
+
+			const int32 BatchIndex = FindOrAddInstancedBatch(StaticMeshComp);
+			const auto InstanceTransform = StaticMeshComp->GetComponentTransform();
+			const int32 InstanceIndex = InstancedBatches[BatchIndex]->AddInstance(InstanceTransform, true);
+			Record.Instances.Add({BatchIndex, InstanceIndex});
+			Record.InstanceTransforms.Add(InstanceTransform);
+			InstanceToRecord.Add({BatchIndex, InstanceIndex}, RecordIndex);
+		}
+
+		MActor->AActor::Destroy(); // Not in the grid, so no metadata to remove
+	}
+}
+
+int32 AMGroundBlock::FindOrAddInstancedBatch(const UStaticMeshComponent* Source)
+{
+	const auto Materials = Source->GetMaterials();
+	const int32 FoundIndex = InstancedBatches.IndexOfByPredicate([Source, &Materials](const UHierarchicalInstancedStaticMeshComponent* Batch)
+	{
+		return Batch->GetStaticMesh() == Source->GetStaticMesh() && Batch->GetMaterials() == Materials;
+	});
+	if (FoundIndex != INDEX_NONE)
+	{
+		return FoundIndex;
+	}
+
+	auto* Batch = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	Batch->SetStaticMesh(Source->GetStaticMesh());
+	for (int32 i = 0; i < Materials.Num(); ++i)
+	{
+		Batch->SetMaterial(i, Materials[i]);
+	}
+	// Same collisions, so traces like the camera occlusion one still hit the instances
+	Batch->SetCollisionProfileName(Source->GetCollisionProfileName());
+	Batch->SetCollisionEnabled(Source->GetCollisionEnabled());
+	Batch->SetCollisionResponseToChannels(Source->GetCollisionResponseToChannels());
+	Batch->SetCastShadow(Source->CastShadow);
+	Batch->SetupAttachment(RootComponent);
+	Batch->RegisterComponent();
+
+	return InstancedBatches.Add(Batch);
+}
+
+AMActor* AMGroundBlock::PromoteInstance(const UPrimitiveComponent* Component, int32 InstanceIndex, bool bKeep)
+{
+	const int32 BatchIndex = InstancedBatches.IndexOfByPredicate([Component](const UHierarchicalInstancedStaticMeshComponent* Batch) { return Batch == Component; });
+	if (BatchIndex == INDEX_NONE)
+		return nullptr;
+
+	const auto* RecordIndex = InstanceToRecord.Find({BatchIndex, InstanceIndex});
+	if (!RecordIndex)
+	{
+		check(false);
+		return nullptr;
+	}
+
+	return PromoteRecord(*RecordIndex, bKeep);
+}
+
+void AMGroundBlock::PromoteInstancesInRadius(const FVector& Location, float Radius, TArray<AMActor*>& OutActors, bool bKeep)
+{
+	for (int32 RecordIndex = 0; RecordIndex < InstancedActors.Num(); ++RecordIndex)
+	{
+		if (FVector::DistSquared2D(InstancedActors[RecordIndex].Transform.GetLocation(), Location) > FMath::Square(Radius))
+			continue;
+
+		if (const auto MActor = PromoteRecord(RecordIndex, bKeep))
+		{
+			OutActors.Add(MActor);
+		}
+	}
+}
+
+TArray<AMActor*> AMGroundBlock::PromoteInstancesAround(const UObject* WorldContextObject, FVector Location, float Radius, bool bKeep)
+{
+	TArray<AMActor*> Result;
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(WorldContextObject);
+	const auto MetadataManager = AMGameMode::GetMetadataManager(WorldContextObject);
+	if (!WorldGenerator || !MetadataManager)
+		return Result;
+
+	const auto MinBlock = WorldGenerator->GetGroundBlockIndex(Location - FVector(Radius, Radius, 0.f));
+	const auto MaxBlock = WorldGenerator->GetGroundBlockIndex(Location + FVector(Radius, Radius, 0.f));
+	for (int32 X = MinBlock.X; X <= MaxBlock.X; ++X)
+	{
+		for (int32 Y = MinBlock.Y; Y <= MaxBlock.Y; ++Y)
+		{
+			if (const auto BlockMetadata = MetadataManager->FindBlock({X, Y}); BlockMetadata && IsValid(BlockMetadata->pGroundBlock))
+			{
+				BlockMetadata->pGroundBlock->PromoteInstancesInRadius(Location, Radius, Result, bKeep);
+			}
+		}
+	}
+	return Result;
+}
+
+AMActor* AMGroundBlock::PromoteRecord(int32 RecordIndex, bool bKeep)
+{
+	auto& Record = InstancedActors[RecordIndex];
+	Record.bKeepPromoted |= bKeep;
+	if (IsValid(Record.PromotedActor))
+	{
+		return Record.PromotedActor;
+	}
+
+	const auto MActor = GetWorld()->SpawnActorDeferred<AMActor>(Record.Class, Record.Transform, this, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!MActor)
+	{
+		check(false);
+		return nullptr;
+	}
+	// Must look exactly as the instances it replaces
+	MActor->SetAppearanceID(Record.AppearanceID);
+	MActor->SetIsRandomizedAppearance(false);
+	// Every client collapses the same content on its own and keeps rendering it, a replicated copy would duplicate it
+	MActor->SetReplicates(false);
+	MActor->FinishSpawning(Record.Transform);
+	MActor->AttachToActor(this, FAttachmentTransformRules::KeepWorldTransform);
+	Record.PromotedActor = MActor;
+
+	// Removed rather than hidden, so they neither render nor block traces meant for the actor
+	for (auto& Instance : Record.Instances)
+	{
+		RemoveBatchInstance(Instance);
+		Instance.Y = INDEX_NONE;
+	}
+
+	return MActor;
+}
+
+void AMGroundBlock::RemoveBatchInstance(const FIntPoint& Instance)
+{
+	const auto Batch = InstancedBatches[Instance.X];
+	const int32 LastIndex = Batch->GetInstanceCount() - 1;
+	Batch->RemoveInstance(Instance.Y);
+	InstanceToRecord.Remove(Instance);
+
+	if (Instance.Y == LastIndex)
+		return;
+
+	const FIntPoint MovedInstance(Instance.X, LastIndex);
+	if (const auto MovedRecordIndex = InstanceToRecord.Find(MovedInstance))
+	{
+		const int32 RecordIndex = *MovedRecordIndex;
+		InstanceToRecord.Remove(MovedInstance);
+		InstanceToRecord.Add(Instance, RecordIndex);
+		if (auto* RecordInstance = InstancedActors[RecordIndex].Instances.FindByKey(MovedInstance))
+		{
+			*RecordInstance = Instance;
+		}
+	}
+}
+
+bool AMGroundBlock::DemoteActor(AMActor* MActor)
+{
+	if (!MActor)
+		return false;
+
+	const int32 RecordIndex = InstancedActors.IndexOfByPredicate([MActor](const FInstancedActorRecord& Record) { return Record.PromotedActor == MActor; });
+	if (RecordIndex == INDEX_NONE || InstancedActors[RecordIndex].bKeepPromoted)
+		return false;
+
+	auto& Record = InstancedActors[RecordIndex];
+	for (int32 i = 0; i < Record.Instances.Num(); ++i)
+	{
+		Record.Instances[i].Y = InstancedBatches[Record.Instances[i].X]->AddInstance(Record.InstanceTransforms[i], true);
+		InstanceToRecord.Add(Record.Instances[i], RecordIndex);
+	}
+	Record.PromotedActor = nullptr;
+	MActor->AActor::Destroy();
+
+	return true;
+}
+
+int AMGroundBlock::GetInstancesNumber() const
+{
+	int Result = 0;
+	for (const auto Batch : InstancedBatches)
+	{
+		Result += Batch->GetInstanceCount();
+	}
+	return Result;
+}
+
+int AMGroundBlock::GetPromotedActorsNumber() const
+{
+	return Algo::CountIf(InstancedActors, [](const FInstancedActorRecord& Record) { return IsValid(Record.PromotedActor); });
+}
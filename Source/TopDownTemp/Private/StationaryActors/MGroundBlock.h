@@ -8,6 +8,37 @@
 #include "MGroundBlock.generated.h"
 
 class UPaperSpriteComponent;
+class UPCGComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/** Decorative actor collapsed into instances of the ground block */
+USTRUCT()
+struct FInstancedActorRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AMActor> Class;
+
+	UPROPERTY()
+	FTransform Transform;
+
+	UPROPERTY()
+	int AppearanceID = 0;
+
+	/** X is the batch index, Y is the instance index within the batch. Y is INDEX_NONE while the actor is promoted */
+	TArray<FIntPoint> Instances;
+
+	/** Transforms of the instances, to add them back after the actor is demoted */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Set while the record is represented by a real actor */
+	UPROPERTY()
+	AMActor* PromotedActor = nullptr;
+
+	/** Promoted because gameplay needs it (interaction, harvest, inventory access). Such actors are never demoted */
+	bool bKeepPromoted = false;
+};
 /**
  * 
  */
@@ -20,15 +51,22 @@ public:
 
 	/** Get the biome from AMWorldGenerator::GetGridOfActors.
 	 * We can't rely on storing biome here because there is a gap between biome setting pass and block generating pass.
-	 * During generating pass each block gets its biome in turn so there would be a risk of adjacent block store an old biome */
+	 * During generating pass each block gets its biome in turn so there would be a risk of adjacent block store an old biome.\n
+	 * Transitions are resolved later by AMWorldGenerator::UpdateBiomeTransitions together with all the blocks changed this frame */
 	UFUNCTION(BlueprintCallable)
 	void UpdateBiome(EBiome IN_Biome);
 
-	/** Function updates the transition if needed. Called by an adjacent block that just received its biome. */
-	void UpdateTransition(FIntPoint Offset, EBiome AdjacentBiome);
+	/** Left; Right; Top; Bottom */
+	static const FIntPoint TransitionOffsets[4];
+
+	void SetTransitionHidden(const FIntPoint& Offset, bool bHidden);
+
+	bool IsTransitionHidden(const FIntPoint& Offset) const;
 
 protected:
 
+	virtual void BeginPlay() override;
+
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION(BlueprintImplementableEvent)
@@ -54,4 +92,71 @@ public:
 
 	UFUNCTION()
 	void OnPCGVariablesReplicated();
+
+	/** Describes the content currently generated by the PCG component, both the instances and the spawned actors.\n
+	 * Must be called before CollapseDecorativeActors() turns the actors into instances */
+	FPCGGenerationResult ComputePCGResult() const;
+
+// Instancing
+public:
+	/** Spawns the actor an instance was collapsed from and removes its instances. Returns nullptr if the component isn't one of the block's batches.\n
+	 * bKeep is for gameplay, the actor then stays for good. Otherwise it's only cosmetic, e.g. for the occlusion fade */
+	AMActor* PromoteInstance(const UPrimitiveComponent* Component, int32 InstanceIndex, bool bKeep = false);
+
+	/** Promotes all the collapsed actors of this block within the radius, see PromoteInstance() for bKeep */
+	void PromoteInstancesInRadius(const FVector& Location, float Radius, TArray<AMActor*>& OutActors, bool bKeep);
+
+	/** Promotes all the collapsed actors within the radius, whatever blocks they belong to.\n
+	 * Must be called by every gameplay path that looks for actors around, as collapsed ones have no collision nor overlaps of their own */
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	static TArray<AMActor*> PromoteInstancesAround(const UObject* WorldContextObject, FVector Location, float Radius, bool bKeep = true);
+
+	/** Destroys the actor if it was promoted from an instance of this block and adds its instances back.\n
+	 * Returns false otherwise, or if it was promoted for good */
+	bool DemoteActor(AMActor* MActor);
+
+	int GetInstancesNumber() const;
+
+	int GetPromotedActorsNumber() const;
+
+protected:
+	/** Replaces the decorative actors spawned by PCG with instances of per-mesh batches */
+	void CollapseDecorativeActors();
+
+	int32 FindOrAddInstancedBatch(const UStaticMeshComponent* Source);
+
+	AMActor* PromoteRecord(int32 RecordIndex, bool bKeep);
+
+	/** Batches remove by swapping the last instance into the freed index, so the record of the moved instance is fixed up */
+	void RemoveBatchInstance(const FIntPoint& Instance);
+
+	/** One batch per mesh and materials combination */
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> InstancedBatches;
+
+	UPROPERTY()
+	TArray<FInstancedActorRecord> InstancedActors;
+
+	/** Batch and instance indices to the index in InstancedActors */
+	TMap<FIntPoint, int32> InstanceToRecord;
+
+protected:
+	UFUNCTION()
+	void OnPCGGenerated(UPCGComponent* PCGComponent);
+
+	UFUNCTION()
+	void OnPCGResultReplicated();
+
+	/** Clients only. Compares the local generation with the server one as soon as both are known */
+	void CheckPCGDeterminism() const;
+
+	/** Nothing the graph produced may lie on the road corridors, unless the graph doesn't exclude them at all */
+	void CheckRoadsExcluded() const;
+
+	/** What the server generated. Replicated separately so it doesn't trigger the generation again */
+	UPROPERTY(ReplicatedUsing=OnPCGResultReplicated)
+	FPCGGenerationResult ServerPCGResult;
+
+	/** Clients only. What this client generated from the replicated variables */
+	FPCGGenerationResult LocalPCGResult;
 };
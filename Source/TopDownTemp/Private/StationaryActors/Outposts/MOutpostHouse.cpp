@@ -1,6 +1,17 @@
 #include "MOutpostHouse.h"
 #include "Characters/MCharacter.h"
+#include "Components/MIsActiveCheckerComponent.h"
 #include "Controllers/MMobControllerBase.h"
+#include "Framework/MGameMode.h"
+#include "Managers/MMetadataManager.h"
+#include "Managers/MWorldGenerator.h"
+
+AMOutpostHouse::AMOutpostHouse(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// Residents follow the house. The Blueprint events are still called from the handlers
+	IsActiveCheckerComponent->OnEnabledDelegate.BindUObject(this, &AMOutpostHouse::OnHouseEnabled);
+	IsActiveCheckerComponent->OnDisabledDelegate.BindUObject(this, &AMOutpostHouse::OnHouseDisabled);
+}
 
 bool AMOutpostHouse::MoveResidentIn(AMCharacter* NewResident)
 {
@@ -38,6 +49,144 @@ void AMOutpostHouse::MoveResidentOut(AMCharacter* OldResident)
 	Residents.Remove(FName(OldResident->GetName()));
 }
 
+bool AMOutpostHouse::AddVirtualResident(TSubclassOf<AActor> ResidentClass)
+{
+	if (!ResidentClass || !ResidentClass->IsChildOf(AMCharacter::StaticClass()))
+	{
+		check(false);
+		return false;
+	}
+
+	// Capacity check
+	if (GetMaterializedResidentsNumber() + VirtualResidents.Num() >= Capacity)
+	{
+		return false;
+	}
+
+	VirtualResidents.AddDefaulted_GetRef().ActorSaveData.FinalClass = ResidentClass;
+	return true;
+}
+
+void AMOutpostHouse::MaterializeResidents()
+{
+	if (VirtualResidents.IsEmpty())
+		return;
+
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!IsValid(WorldGenerator))
+		return;
+
+	const auto EntryPoint = GetEntryPoint();
+	const auto ToMaterialize = MoveTemp(VirtualResidents);
+	VirtualResidents.Reset();
+
+	for (const auto& ResidentSD : ToMaterialize)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		// Restore the state if the resident was materialized before
+		FOnSpawnActorStarted OnSpawnActorStarted;
+		if (IsUidValid(ResidentSD.ActorSaveData.Uid))
+		{
+			OnSpawnActorStarted.AddLambda([&ResidentSD](AActor* Actor)
+			{
+				if (const auto MCharacter = Cast<AMCharacter>(Actor))
+				{
+					MCharacter->BeginLoadFromSD(ResidentSD);
+				}
+				else check(false);
+			});
+		}
+
+		const auto Resident = WorldGenerator->SpawnActor<AMCharacter>(ResidentSD.ActorSaveData.FinalClass.Get(), EntryPoint, FRotator::ZeroRotator, SpawnParameters, true, OnSpawnActorStarted, ResidentSD.ActorSaveData.Uid);
+		if (!Resident)
+		{
+			check(false);
+			continue;
+		}
+
+		MoveResidentIn(Resident);
+	}
+}
+
+void AMOutpostHouse::DematerializeResidents()
+{
+	// The house might have been enabled again while waiting
+	if (IsActiveCheckerComponent->GetIsActive())
+		return;
+
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	const auto MetadataManager = AMGameMode::GetMetadataManager(this);
+	if (!IsValid(WorldGenerator) || !IsValid(MetadataManager))
+		return;
+
+	TArray<AMCharacter*> ToDematerialize;
+	for (const auto& [Name, Resident] : Residents)
+	{
+		if (!IsValid(Resident))
+			continue;
+
+		// Keep the residents who went away from home and are still seen by someone
+		const auto* BlockMetadata = MetadataManager->FindBlock(WorldGenerator->GetGroundBlockIndex(Resident->GetActorLocation()));
+		if (BlockMetadata && !BlockMetadata->ObserverFlags.IsEmpty())
+			continue;
+
+		ToDematerialize.Add(Resident);
+	}
+
+	for (const auto Resident : ToDematerialize)
+	{
+		auto ResidentSD = Resident->GetSaveData();
+		ResidentSD.HouseUid = {}; // The house moves the resident in by itself when materializing
+		VirtualResidents.Add(ResidentSD);
+
+		MoveResidentOut(Resident);
+		Resident->Destroy();
+	}
+}
+
+int AMOutpostHouse::GetMaterializedResidentsNumber() const
+{
+	int Number = 0;
+	for (const auto& [Name, Resident] : Residents)
+	{
+		if (IsValid(Resident))
+		{
+			++Number;
+		}
+	}
+	return Number;
+}
+
+FMActorSaveData AMOutpostHouse::GetSaveData() const
+{
+	auto MActorSD = Super::GetSaveData();
+	// Materialized residents are saved on their own and refer to the house by HouseUid
+	MActorSD.VirtualResidents = VirtualResidents;
+
+	return MActorSD;
+}
+
+void AMOutpostHouse::BeginLoadFromSD(const FMActorSaveData& MActorSD)
+{
+	Super::BeginLoadFromSD(MActorSD);
+	VirtualResidents = MActorSD.VirtualResidents;
+}
+
+void AMOutpostHouse::OnHouseEnabled()
+{
+	OnEnabled();
+	MaterializeResidents();
+}
+
+void AMOutpostHouse::OnHouseDisabled()
+{
+	OnDisabled();
+	// Blocks are still being processed by the world generator, wait for all the observer flags to be updated
+	GetWorldTimerManager().SetTimerForNextTick(this, &AMOutpostHouse::DematerializeResidents);
+}
+
 FVector AMOutpostHouse::GetEntryPoint() const
 {
 	TArray<USceneComponent*> ChildComponents;
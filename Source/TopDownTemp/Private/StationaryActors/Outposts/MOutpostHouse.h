@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "StationaryActors/Outposts/MOutpostElement.h"
+#include "Managers/SaveManager/MWorldSaveTypes.h"
 #include "MOutpostHouse.generated.h"
 
 class AMCharacter;
@@ -9,12 +10,13 @@ class AMOutpostGenerator;
 
 //~=============================================================================
 /**
- * Base class for housing that is part of an outpost.\n It can be any building which accommodates several residents
+ * Base class for housing that is part of an outpost.\n It can be any building which accommodates several residents.\n
+ * Residents are kept as lightweight records while nobody observes the house and materialized into characters when someone does
  */
 UCLASS(Blueprintable)
 class AMOutpostHouse : public AMOutpostElement
 {
-	GENERATED_BODY()
+	GENERATED_UCLASS_BODY()
 
 public:
 	/** Validates all current residents, O(n) complexity */
@@ -22,14 +24,39 @@ public:
 
 	void MoveResidentOut(AMCharacter* OldResident);
 
+	/** Stores a record instead of spawning the character. It is materialized as soon as the house is enabled */
+	bool AddVirtualResident(TSubclassOf<AActor> ResidentClass);
+
+	/** Spawns characters for all the virtual residents at the entry point */
+	void MaterializeResidents();
+
+	/** Turns residents back into records, skipping those who are still observed by someone */
+	void DematerializeResidents();
+
+	int GetMaterializedResidentsNumber() const;
+
+	int GetVirtualResidentsNumber() const { return VirtualResidents.Num(); }
+
 	UFUNCTION(BlueprintCallable)
 	FVector GetEntryPoint() const;
 
 protected:
 
+	virtual FMActorSaveData GetSaveData() const override;
+
+	virtual void BeginLoadFromSD(const FMActorSaveData& MActorSD) override;
+
+	void OnHouseEnabled();
+
+	void OnHouseDisabled();
+
 	UPROPERTY()
 	TMap<FName, AMCharacter*> Residents;
 
+	/** Residents that exist only as save data. Uid is valid only if the resident was materialized before */
+	UPROPERTY()
+	TArray<FMCharacterSaveData> VirtualResidents;
+
 	UPROPERTY(EditDefaultsOnly)
 	int Capacity = 2;
 };
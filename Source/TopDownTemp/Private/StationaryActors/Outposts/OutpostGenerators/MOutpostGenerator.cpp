@@ -2,140 +2,308 @@
 
 #include "MOutpostGenerator.h"
 
+#include "Async/Async.h"
 #include "Framework/MGameMode.h"
+#include "Managers/MBlockGenerator.h"
+#include "Managers/MWorldGenerator.h"
 #include "Managers/SaveManager/MWorldSaveTypes.h"
 #include "StationaryActors/Outposts/MGap.h"
 #include "StationaryActors/Outposts/MOutpostHouse.h"
-#include "Characters/MCharacter.h" // TODO: Remove this when refactor usage of PopulateResidentsInHouse
+#include "StationaryActors/MGroundBlock.h"
+#include "Components/MIsActiveCheckerComponent.h"
 #include "Helpers/M2DRepresentationBlueprintLibrary.h"
 
 DEFINE_LOG_CATEGORY(LogOutpostGenerator);
 
-void AMOutpostGenerator::GenerateOnCirclePerimeter(FVector Center, float CircleRadius,
-	const TArray<UMElementDataForGeneration*>& ElementsData)
+TArray<FOutpostLayoutPlacement> AMOutpostGenerator::ComputeLayout(const FOutpostLayoutRequest& Request)
 {
-	UWorld* World = GetWorld();
-	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMOutpostGenerator::ComputeLayout);
 
-	if (!WorldGenerator || ElementsData.IsEmpty())
+	FRandomStream RandomStream(Request.Seed);
+	TArray<FBox2D> OccupiedAreas = Request.OccupiedAreas;
+	TArray<FOutpostLayoutPlacement> Placements;
+
+	for (int32 CircleIndex = 0; CircleIndex < Request.Circles.Num(); ++CircleIndex)
+	{
+		const auto& Circle = Request.Circles[CircleIndex];
+		float CircleRadius = Circle.Radius;
+
+		// Gaps only keep the space free on their own circle, so their footprints are not carried over to the next one
+		TArray<FBox2D> CircleOccupiedAreas = OccupiedAreas;
+
+		// The generation goes on a circle perimeter.
+		// We place the elements one by one from top to bottom, starting with the left semicircle and then alternating
+		//
+		//        [1st]
+		//   [3rd]      [2nd]
+		// [5th]         [4th] ...
+		//   []          []  ...
+		//    []        []   ...
+		//
+		//
+		// We do a binary searchIn to find the closest eligible position so the element does not intersect already placed.
+
+		// Index for "even-odd" check to know which semicircle to go
+		int ElementIndex = 0;
+
+		// Number of each element kind required to be built. Its elements are going to be being removed.
+		// Keys are indexes in Circle.ElementKinds
+		TMap<int32, int> ElementsCountData;
+		for (int32 KindIndex = 0; KindIndex < Circle.ElementKinds.Num(); ++KindIndex)
+		{
+			const auto& CountRange = Circle.ElementKinds[KindIndex].CountRange;
+			if (const int Number = RandomStream.RandRange(CountRange.X, CountRange.Y); Number > 0)
+			{
+				ElementsCountData.Add(KindIndex, Number);
+			}
+		}
+
+		int RadiusIncrements = 0;
+		while(!ElementsCountData.IsEmpty())
+		{
+			// The kind of the new element is random
+			TArray<int32> RemainedIndexes;
+			ElementsCountData.GetKeys(RemainedIndexes);
+			const int32 KindIndex = RemainedIndexes[RandomStream.RandRange(0, RemainedIndexes.Num() - 1)];
+			const auto& ElementKind = Circle.ElementKinds[KindIndex];
+
+			// We try to find a location to fit the element
+			if (const auto Location = FindLocationOnCircle(ElementKind.Footprint, ElementIndex, Circle.Center, CircleRadius, CircleOccupiedAreas); Location.IsSet())
+			{
+				const auto ElementArea = ElementKind.Footprint.ShiftBy(FVector2D(Location.GetValue()));
+				CircleOccupiedAreas.Add(ElementArea);
+				if (!ElementKind.bGap)
+				{
+					OccupiedAreas.Add(ElementArea);
+				}
+				++ElementIndex;
+
+				--ElementsCountData[KindIndex];
+				if (ElementsCountData[KindIndex] == 0)
+				{
+					ElementsCountData.Remove(KindIndex);
+				}
+
+				if (ElementKind.bGap) // Gaps only reserve the space
+					continue;
+
+				auto& Placement = Placements.AddDefaulted_GetRef();
+				Placement.CircleIndex = CircleIndex;
+				Placement.DataIndex = ElementKind.DataIndex;
+				Placement.Location = Location.GetValue();
+				for (const auto& ResidentsCountRange : ElementKind.ResidentsCountRanges)
+				{
+					Placement.ResidentsCounts.Add(RandomStream.RandRange(ResidentsCountRange.X, ResidentsCountRange.Y));
+				}
+			}
+			else
+			{
+				// Previous implementation was such: If cannot place an actor, then stop and don't build the rest.
+
+				//One of possible solutions to develop generation. It hasn't been proved yet and the binary search isn't suitable for it.
+				// The idea is to keep increasing the radius of generation each time we couldn't fit an actor.
+				// Obviously, the order of the actors is important, because trying to place a big one will result in an increase
+				// in the generation radius, although there may still be unplaced small ones that could fit.
+				// But the village should have a chaotic structure, so for now this is acceptable.
+				CircleRadius += Request.RadiusIncrement;
+				if (++RadiusIncrements > Request.MaxRadiusIncrements)
+				{
+					UE_LOG(LogOutpostGenerator, Warning, TEXT("Couldn't fit %d kinds of elements on the circle %d, skipping them"), ElementsCountData.Num(), CircleIndex);
+					break;
+				}
+			}
+		}
+	}
+
+	return Placements;
+}
+
+FOutpostLayoutCircle AMOutpostGenerator::MakeLayoutCircle(const FVector& Center, float CircleRadius,
+	const TArray<UMElementDataForGeneration*>& ElementsData, TArray<UMElementDataForGeneration*>& OutElementsData, UObject* WorldContextObject)
+{
+	FOutpostLayoutCircle Circle;
+	Circle.Center = Center;
+	Circle.Radius = CircleRadius;
+
+	for (const auto Data : ElementsData)
+	{
+		if (!Data || !Data->ToSpawnClass)
+		{
+			check(false);
+			continue;
+		}
+
+		auto& ElementKind = Circle.ElementKinds.AddDefaulted_GetRef();
+		ElementKind.DataIndex = OutElementsData.Add(Data);
+		ElementKind.CountRange = Data->GetCountRange();
+		ElementKind.bGap = Data->ToSpawnClass->IsChildOf(AMGap::StaticClass());
+
+		const auto DefaultBounds = AMWorldGenerator::GetDefaultBounds(Data->ToSpawnClass.Get(), WorldContextObject);
+		ElementKind.Footprint = FBox2D(FVector2D(DefaultBounds.Origin - DefaultBounds.BoxExtent), FVector2D(DefaultBounds.Origin + DefaultBounds.BoxExtent));
+
+		if (const auto* HouseData = Cast<UMHouseDataForGeneration>(Data))
+		{
+			for (const auto& [ResidentClass, ResidentData] : HouseData->ResidentsDataMap)
+			{
+				ElementKind.ResidentsCountRanges.Add(ResidentData ? ResidentData->GetCountRange() : FIntPoint::ZeroValue);
+			}
+		}
+	}
+
+	return Circle;
+}
+
+void AMOutpostGenerator::LaunchLayoutGeneration()
+{
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!WorldGenerator || bLayoutInProgress)
 	{
 		check(false);
 		return;
 	}
 
-	const FVector TopPoint = GetPointOnCircle(Center, CircleRadius, 0.f);
+	LayoutCircles.Empty();
+	LayoutElementsData.Empty();
+	GetLayoutCircles(GetActorLocation(), LayoutCircles, LayoutElementsData, this);
+	if (LayoutCircles.IsEmpty())
+		return;
+
+	// Generate() marked the outpost as generated, but the elements are yet to be spawned
+	bGenerated = false;
+
+	FOutpostLayoutRequest Request;
+	Request.Circles = LayoutCircles;
+	Request.Seed = FMath::Rand();
 
 	const auto BlockSize = WorldGenerator->GetGroundBlockSize();
 	const auto PCGGraphVillage = WorldGenerator->GetBlockGenerator()->GetGraph("Village"); // TODO: make a parameter
-	// Here we should clean all the blocks we are about to cover
-	WorldGenerator->RegenerateArea(Center, FMath::CeilToInt(CircleRadius / FMath::Min(BlockSize.X, BlockSize.Y)), PCGGraphVillage); //TODO: Increase the area somehow! for now I don't know how to calculate it
-
-	// The generation goes on a circle perimeter.
-	// We place the elements one by one from top to bottom, starting with the left semicircle and then alternating
-	//
-	//        [1st]
-	//   [3rd]      [2nd]
-	// [5th]         [4th] ...
-	//   []          []  ...
-	//    []        []   ...
-	//
-	//
-	// We do a binary searchIn to find the closest eligible position so the element does not intersect already placed.
-
-	// Index for "even-odd" check to know which semicircle to go
-	int ElementIndex = 0;
-
-	// Number of each element required to be built. Its elements are going to be being removed.
-	// Use pointers as keys to access metadata.
-	TMap<const UMElementDataForGeneration*, int> ElementsCountData;
-	for (auto& Data : ElementsData)
+	for (const auto& Circle : LayoutCircles)
 	{
-		if (const int Number = Data->GetRandomCount(); Number > 0)
+		// Here we should clean all the blocks we are about to cover
+		WorldGenerator->RegenerateArea(Circle.Center, FMath::CeilToInt(Circle.Radius / FMath::Min(BlockSize.X, BlockSize.Y)), PCGGraphVillage); //TODO: Increase the area somehow! for now I don't know how to calculate it
+
+		// Whatever blocking survived the regeneration is respected by the layout.
+		// The circle may grow while elements don't fit, so cover the largest radius it can reach, plus the biggest footprint
+		float MaxFootprintExtent = 0.f;
+		for (const auto& ElementKind : Circle.ElementKinds)
 		{
-			ElementsCountData.Add(Data, Number);
+			MaxFootprintExtent = FMath::Max(MaxFootprintExtent, ElementKind.Footprint.GetExtent().GetMax());
 		}
-	}
-
-	while(!ElementsCountData.IsEmpty())
-	{
-		FActorSpawnParameters SpawnParameters;
-		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-		// The class of the new element is random
-		TArray<const UMElementDataForGeneration*> RemainedIndexes;
-		ElementsCountData.GetKeys(RemainedIndexes);
-		const int32 RandomIndex = FMath::RandRange(0, RemainedIndexes.Num() - 1);
-		const auto* ElementData = RemainedIndexes[RandomIndex];
-
-		// A temporary actor to "try on" a position for the element
-		const auto TestingElementActor = World->SpawnActor<AMOutpostElement>(ElementData->ToSpawnClass.Get(), TopPoint, FRotator::ZeroRotator, SpawnParameters);
-		if (!TestingElementActor)
+		const float MaxRadius = Circle.Radius + Request.RadiusIncrement * Request.MaxRadiusIncrements + MaxFootprintExtent;
+		const FVector CircleExtent(MaxRadius, MaxRadius, 0.f);
+		for (const auto& [Name, Actor] : WorldGenerator->GetActorsInRect(Circle.Center - CircleExtent, Circle.Center + CircleExtent, false))
 		{
-			check(false);
-			return;
+			if (!IsValid(Actor) || Actor->IsA(AMGroundBlock::StaticClass()) || !Actor->GetActorEnableCollision())
+				continue;
+
+			FVector Origin, BoxExtent;
+			Actor->GetActorBounds(true, Origin, BoxExtent);
+			Request.OccupiedAreas.Add(FBox2D(FVector2D(Origin - BoxExtent), FVector2D(Origin + BoxExtent)));
 		}
+	}
 
-		// We try to find a location to fit the element
-		if (const auto Location = FindLocationOnCircle(*TestingElementActor, ElementIndex, Center, CircleRadius); Location.IsSet())
-		{
-			TestingElementActor->SetActorLocation(Location.GetValue());
-			ElementsMap.Add(FName(TestingElementActor->GetName()), TestingElementActor);
-			++ElementIndex;
+	bLayoutInProgress = true;
 
-			--ElementsCountData[ElementData];
-			if (ElementsCountData[ElementData] == 0)
+	// The layout only reads plain data, so it doesn't need the game thread. Spawning does, so we get back to it after
+	Async(EAsyncExecution::ThreadPool, [WeakThis = TWeakObjectPtr<AMOutpostGenerator>(this), Request = MoveTemp(Request)]
+	{
+		auto Placements = ComputeLayout(Request);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Placements = MoveTemp(Placements)]() mutable
+		{
+			if (WeakThis.IsValid())
 			{
-				ElementsCountData.Remove(ElementData);
+				WeakThis->OnLayoutComputed(MoveTemp(Placements));
 			}
+		});
+	});
+}
 
-			// Enroll element to the grid and do some custom post-spawn things like populating residents
-			if (!ElementData->ToSpawnClass->IsChildOf(AMGap::StaticClass())) // Skip gaps since they are going to be deleted
-			{
-				ProcessShiftOptions(TestingElementActor, ElementData, Center);
+void AMOutpostGenerator::OnLayoutComputed(TArray<FOutpostLayoutPlacement>&& Placements)
+{
+	PendingPlacements = MoveTemp(Placements);
+	OnTickSpawnElements();
+}
 
-				WorldGenerator->EnrollActorToGrid(TestingElementActor);
+void AMOutpostGenerator::OnTickSpawnElements()
+{
+	UWorld* World = GetWorld();
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!World || !WorldGenerator)
+	{
+		check(false);
+		return;
+	}
 
-				if (auto* OutpostHouse = Cast<AMOutpostHouse>(TestingElementActor))
-				{
-					OutpostHouse->SetOwnerOutpost(this);
-					Houses.Add(FName(OutpostHouse->GetName()), OutpostHouse);
-					if (const auto* HouseMetadata = Cast<UMHouseDataForGeneration>(ElementData))
-					{
-						PopulateResidentsInHouse(OutpostHouse, HouseMetadata);
-					}
-				}
-			}
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int ToSpawnNumber = FMath::Min(FMath::Max(ElementsSpawnBudgetPerTick, 1), PendingPlacements.Num());
+	for (int i = 0; i < ToSpawnNumber; ++i)
+	{
+		const auto& Placement = PendingPlacements[i];
+		const auto* ElementData = LayoutElementsData.IsValidIndex(Placement.DataIndex) ? LayoutElementsData[Placement.DataIndex] : nullptr;
+		if (!ElementData || !LayoutCircles.IsValidIndex(Placement.CircleIndex))
+		{
+			check(false);
+			continue;
 		}
-		else
+
+		const auto ElementActor = World->SpawnActor<AMOutpostElement>(ElementData->ToSpawnClass.Get(), Placement.Location, FRotator::ZeroRotator, SpawnParameters);
+		if (!ElementActor)
 		{
-			TestingElementActor->AActor::Destroy(); // Used plain AActor::Destroy(), and it's OK, because spawned element didn't get EnrollActorToGrid() called
+			check(false);
+			continue;
+		}
+		ElementsMap.Add(FName(ElementActor->GetName()), ElementActor);
 
-			// Previous implementation was such: If cannot place an actor, then stop and don't build the rest.
+		ProcessShiftOptions(ElementActor, ElementData, LayoutCircles[Placement.CircleIndex].Center);
 
-			//One of possible solutions to develop generation. It hasn't been proved yet and the binary search isn't suitable for it.
-			// The idea is to keep increasing the radius of generation each time we couldn't fit an actor.
-			// Obviously, the order of the actors is important, because trying to place a big one will result in an increase
-			// in the generation radius, although there may still be unplaced small ones that could fit.
-			// But the village should have a chaotic structure, so for now this is acceptable.
-			CircleRadius += 500.f; // TODO: Add a parameter for this
-			// TODO: Ensure this doesn't cause endless loop
-		}
+		SpawnedElements.Add(ElementActor);
+		SpawnedPlacements.Add(Placement);
 	}
+	PendingPlacements.RemoveAt(0, ToSpawnNumber);
 
-	// Remove all spawned Gap actors
-	TArray<FName> KeysToRemove;
-	for (auto It = ElementsMap.CreateIterator(); It; ++It)
+	if (!PendingPlacements.IsEmpty())
 	{
-		if (It.Value()->GetClass()->IsChildOf(AMGap::StaticClass()))
-		{
-			KeysToRemove.Add(It->Key);
-		}
+		World->GetTimerManager().SetTimerForNextTick(this, &AMOutpostGenerator::OnTickSpawnElements);
+		return;
 	}
-	for (const auto& Key : KeysToRemove)
+
+	EnrollSpawnedElements();
+
+	bLayoutInProgress = false;
+	bGenerated = true;
+	LayoutCircles.Empty();
+	LayoutElementsData.Empty();
+}
+
+void AMOutpostGenerator::EnrollSpawnedElements()
+{
+	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
+	if (!WorldGenerator) { check(false); return; }
+
+	// Enroll elements to the grid and do some custom post-spawn things like populating residents
+	for (int32 i = 0; i < SpawnedElements.Num(); ++i)
 	{
-		ElementsMap[Key]->AActor::Destroy(); // We use plain AActor::Destroy() because Gaps were spawned not as a part of the Grid System
-		ElementsMap.Remove(Key);
+		const auto ElementActor = SpawnedElements[i];
+		if (!IsValid(ElementActor))
+			continue;
+
+		WorldGenerator->EnrollActorToGrid(ElementActor);
+
+		if (auto* OutpostHouse = Cast<AMOutpostHouse>(ElementActor))
+		{
+			const auto& Placement = SpawnedPlacements[i];
+			OutpostHouse->SetOwnerOutpost(this);
+			Houses.Add(FName(OutpostHouse->GetName()), OutpostHouse);
+			if (const auto* HouseMetadata = Cast<UMHouseDataForGeneration>(LayoutElementsData[Placement.DataIndex]))
+			{
+				PopulateResidentsInHouse(OutpostHouse, HouseMetadata, Placement.ResidentsCounts);
+			}
+		}
 	}
+	SpawnedElements.Empty();
+	SpawnedPlacements.Empty();
 }
 
 FMActorSaveData AMOutpostGenerator::GetSaveData() const
@@ -214,8 +382,8 @@ void AMOutpostGenerator::RotateMeshToPoint(const AMOutpostElement* Element, cons
 	}
 }
 
-TOptional<FVector> AMOutpostGenerator::FindLocationOnCircle(const AMOutpostElement& TestingElementActor, int ElementIndex,
-                                                            FVector Center, float CircleRadius) const
+TOptional<FVector> AMOutpostGenerator::FindLocationOnCircle(const FBox2D& Footprint, int ElementIndex, FVector Center,
+                                                            float CircleRadius, const TArray<FBox2D>& OccupiedAreas)
 {
 	constexpr int PrecisionStepsNumber = 7; // It's impossible to know when exactly to stop
 	TOptional<FVector> LastValidPosition;
@@ -229,7 +397,8 @@ TOptional<FVector> AMOutpostGenerator::FindLocationOnCircle(const AMOutpostEleme
 		const auto Mid = (BottomPointAngle + TopPointAngle) / 2.f;
 
 		const auto Location = GetPointOnCircle(Center, CircleRadius, Mid);
-		const bool bIsEncroaching = GetWorld()->EncroachingBlockingGeometry(&TestingElementActor, Location, FRotator::ZeroRotator);
+		const auto ElementArea = Footprint.ShiftBy(FVector2D(Location));
+		const bool bIsEncroaching = OccupiedAreas.ContainsByPredicate([&ElementArea](const FBox2D& Area) { return Area.Intersect(ElementArea); });
 		if (!bIsEncroaching)
 		{
 			BottomPointAngle = Mid;
@@ -258,33 +427,25 @@ TOptional<FVector> AMOutpostGenerator::FindLocationOnCircle(const AMOutpostEleme
 }
 
 void AMOutpostGenerator::PopulateResidentsInHouse(AMOutpostHouse* HouseActor,
-	const UMHouseDataForGeneration* HouseData)
+	const UMHouseDataForGeneration* HouseData, const TArray<int32>& ResidentsCounts)
 {
-	const auto WorldGenerator = AMGameMode::GetWorldGenerator(this);
-	if (!IsValid(WorldGenerator))
-		return;
-
-	// Calculate the amount of villagers to be spawned and spawn them at the entry point of the building.
-	if (const auto EntryPointComponent = Cast<USceneComponent>(HouseActor->GetDefaultSubobjectByName(TEXT("EntryPoint"))))
+	// The amount of villagers was rolled with the layout. They are stored as records and
+	// the house spawns them at its entry point only when someone is around
+	int ResidentKindIndex = 0;
+	for (const auto& [VillagerClass, ToSpawnVillagerMetadata] : HouseData->ResidentsDataMap)
 	{
-		const auto EntryPoint = EntryPointComponent->GetComponentTransform().GetLocation();
-
-		for (const auto& [VillagerClass, ToSpawnVillagerMetadata] : HouseData->ResidentsDataMap)
+		const int RequiredVillagersNumber = ResidentsCounts.IsValidIndex(ResidentKindIndex) ? ResidentsCounts[ResidentKindIndex] : 0;
+		++ResidentKindIndex;
+		for (int i = 0; i < RequiredVillagersNumber; ++i)
 		{
-			const int RequiredVillagersNumber = ToSpawnVillagerMetadata->GetRandomCount();
-			for (int i = 0; i < RequiredVillagersNumber; ++i)
-			{
-				FActorSpawnParameters SpawnParameters;
-				SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-				const auto VillagerPawn = WorldGenerator->SpawnActor<AMCharacter>(VillagerClass.Get(), EntryPoint, FRotator::ZeroRotator, SpawnParameters, true);
-				if (!VillagerPawn)
-				{
-					check(false);
-					continue;
-				}
-
-				HouseActor->MoveResidentIn(VillagerPawn);
-			}
+			if (!HouseActor->AddVirtualResident(VillagerClass))
+				break;
 		}
 	}
+
+	if (const auto HouseIsActiveChecker = HouseActor->FindComponentByClass<UMIsActiveCheckerComponent>();
+		HouseIsActiveChecker && HouseIsActiveChecker->GetIsActive())
+	{
+		HouseActor->MaterializeResidents();
+	}
 }
@@ -15,7 +15,7 @@ enum class EShiftOptions : uint8
 {
 	None = 0,
 	RandomRotateAndMove,
-	// When call GenerateOnCirclePerimeter() there is a center of the circle. This is not necessarily the outpost's center
+	// Each layout circle (see GetLayoutCircles()) has a center. This is not necessarily the outpost's center
 	RotateToLocalCenter,
 	// Does the same as RotateToLocalCenter, but with a slight error for randomness effect
 	RotateToLocalCenterSloppy,
@@ -30,6 +30,9 @@ class UMCountData : public UObject
 public:
 	int GetRandomCount() const { return FMath::RandRange(MinNumberOfInstances, MaxNumberOfInstances); }
 
+	/** Min-Max range packed as X-Y. Used to roll the count outside the game thread */
+	FIntPoint GetCountRange() const { return { MinNumberOfInstances, MaxNumberOfInstances }; }
+
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
 	int MinNumberOfInstances;
@@ -70,6 +73,63 @@ public:
 	TMap<TSubclassOf<AActor>, UMResidentDataForGeneration*> ResidentsDataMap;
 };
 
+/** Copy of one UMElementDataForGeneration, plain data only, so the layout can be computed off the game thread */
+struct FOutpostLayoutElementKind
+{
+	/** Index of the original UMElementDataForGeneration in AMOutpostGenerator::LayoutElementsData */
+	int32 DataIndex = INDEX_NONE;
+
+	/** XY bounds of the default object relative to the actor origin. See AMWorldGenerator::GetDefaultBounds */
+	FBox2D Footprint = FBox2D(ForceInit);
+
+	FIntPoint CountRange = FIntPoint::ZeroValue;
+
+	/** Gaps only reserve space, they are never spawned */
+	bool bGap = false;
+
+	/** Count ranges for each resident class, in the order of UMHouseDataForGeneration::ResidentsDataMap */
+	TArray<FIntPoint> ResidentsCountRanges;
+};
+
+/** One circle perimeter to place the elements on. Circles are processed in order, later ones respect earlier ones */
+struct FOutpostLayoutCircle
+{
+	FVector Center = FVector::ZeroVector;
+
+	float Radius = 0.f;
+
+	TArray<FOutpostLayoutElementKind> ElementKinds;
+};
+
+struct FOutpostLayoutRequest
+{
+	TArray<FOutpostLayoutCircle> Circles;
+
+	/** XY bounds of the blocking actors that were already in the area */
+	TArray<FBox2D> OccupiedAreas;
+
+	/** How much the circle grows each time an element doesn't fit */
+	float RadiusIncrement = 500.f;
+
+	/** Give up on an element after this many radius increments */
+	int32 MaxRadiusIncrements = 10;
+
+	int32 Seed = 0;
+};
+
+/** Result of the layout computation for one element */
+struct FOutpostLayoutPlacement
+{
+	int32 CircleIndex = INDEX_NONE;
+
+	int32 DataIndex = INDEX_NONE;
+
+	FVector Location = FVector::ZeroVector;
+
+	/** Rolled number of residents for each resident class of a house */
+	TArray<int32> ResidentsCounts;
+};
+
 /**
  * The base class for all outpost generators. They are responsible for spawning buildings,
  * determining their, types, quantity and other specifics within one outpost.
@@ -82,7 +142,8 @@ class TOPDOWNTEMP_API AMOutpostGenerator : public AMActor
 public:
 	virtual void Generate() { bGenerated = true; };
 
-	bool IsGenerated() const { return bGenerated; }
+	/** True once generation was launched. The elements may still be spawning, see bGenerated */
+	bool IsGenerated() const { return bGenerated || bLayoutInProgress; }
 
 	float GetRadius() const { return Radius; }
 
@@ -91,8 +152,27 @@ public:
 		return { CircleCenter.X + Radius * cos(Angle), CircleCenter.Y + Radius * sin(Angle), 0.f };
 	}
 
+	/** Lists the circles the outpost elements are placed on. Works on the class default object as well */
+	virtual void GetLayoutCircles(const FVector& Center, TArray<FOutpostLayoutCircle>& OutCircles, TArray<UMElementDataForGeneration*>& OutElementsData, UObject* WorldContextObject) const {}
+
+	/** Pure function, doesn't touch any UObject. Safe to be called from any thread */
+	static TArray<FOutpostLayoutPlacement> ComputeLayout(const FOutpostLayoutRequest& Request);
+
 protected:
-	void GenerateOnCirclePerimeter(FVector Center, float CircleRadius, const TArray<UMElementDataForGeneration*>& ElementsData);
+	/** Copies the footprints and counts of the given elements. The data itself is appended to OutElementsData to be referenced by DataIndex */
+	static FOutpostLayoutCircle MakeLayoutCircle(const FVector& Center, float CircleRadius, const TArray<UMElementDataForGeneration*>& ElementsData, TArray<UMElementDataForGeneration*>& OutElementsData, UObject* WorldContextObject);
+
+	/** Cleans the area, computes the layout on a worker thread and then spawns the elements over multiple ticks */
+	void LaunchLayoutGeneration();
+
+	void OnLayoutComputed(TArray<FOutpostLayoutPlacement>&& Placements);
+
+	/** Function for spreading heavy element spawning over multiple ticks */
+	void OnTickSpawnElements();
+
+	/** Elements join the grid, and so the saves, only once all of them have spawned.\n
+	 * A save taken in the middle of spawning has none of them, and the outpost is generated again on load without duplicates */
+	void EnrollSpawnedElements();
 
 	FMActorSaveData GetSaveData() const override;
 
@@ -105,10 +185,11 @@ protected:
 
 	static void RotateMeshToPoint(const AMOutpostElement* Element, const FVector& Point);
 
-	TOptional<FVector> FindLocationOnCircle(const AMOutpostElement& TestingElementActor, int ElementIndex, FVector Center, float CircleRadius) const;
+	static TOptional<FVector> FindLocationOnCircle(const FBox2D& Footprint, int ElementIndex, FVector Center, float CircleRadius, const TArray<FBox2D>& OccupiedAreas);
 
-	void PopulateResidentsInHouse(AMOutpostHouse* HouseActor, const UMHouseDataForGeneration* HouseData);
+	void PopulateResidentsInHouse(AMOutpostHouse* HouseActor, const UMHouseDataForGeneration* HouseData, const TArray<int32>& ResidentsCounts);
 
+	/** Set only when all the elements have spawned, so a save taken in the middle of it generates the outpost again on load */
 	bool bGenerated = false;
 
 	/** Outpost bounds */ // TODO: This variable is a bit vague, need some strict requirements
@@ -121,4 +202,26 @@ protected:
 	/** All elements of the outpost. */
 	UPROPERTY()
 	TMap<FName, AMOutpostElement*> ElementsMap;
+
+	/** Max number of elements (with their residents) spawned per tick */
+	UPROPERTY(EditDefaultsOnly)
+	int ElementsSpawnBudgetPerTick = 2;
+
+	/** Element data referenced by FOutpostLayoutElementKind::DataIndex */
+	UPROPERTY()
+	TArray<UMElementDataForGeneration*> LayoutElementsData;
+
+	TArray<FOutpostLayoutCircle> LayoutCircles;
+
+	/** Computed placements waiting to be spawned */
+	TArray<FOutpostLayoutPlacement> PendingPlacements;
+
+	/** Spawned but not yet enrolled elements, see EnrollSpawnedElements() */
+	UPROPERTY()
+	TArray<AMOutpostElement*> SpawnedElements;
+
+	/** Placements of SpawnedElements, in the same order */
+	TArray<FOutpostLayoutPlacement> SpawnedPlacements;
+
+	bool bLayoutInProgress = false;
 };
@@ -21,7 +21,13 @@ void AMVillageGenerator::Generate()
 {
 	Super::Generate();
 
-	GenerateOnCirclePerimeter(GetActorLocation(), HousesCircleRadius, HousesData);
+	LaunchLayoutGeneration();
+}
+
+void AMVillageGenerator::GetLayoutCircles(const FVector& Center, TArray<FOutpostLayoutCircle>& OutCircles,
+	TArray<UMElementDataForGeneration*>& OutElementsData, UObject* WorldContextObject) const
+{
+	OutCircles.Add(MakeLayoutCircle(Center, HousesCircleRadius, HousesData, OutElementsData, WorldContextObject));
 
-	GenerateOnCirclePerimeter(GetActorLocation(), StallsCircleRadius, StallsData);
+	OutCircles.Add(MakeLayoutCircle(Center, StallsCircleRadius, StallsData, OutElementsData, WorldContextObject));
 }
@@ -23,6 +23,9 @@ class TOPDOWNTEMP_API AMVillageGenerator : public AMOutpostGenerator
 public:
 	virtual void Generate() override;
 
+	/** Houses go first, then the stalls inside of them */
+	virtual void GetLayoutCircles(const FVector& Center, TArray<FOutpostLayoutCircle>& OutCircles, TArray<UMElementDataForGeneration*>& OutElementsData, UObject* WorldContextObject) const override;
+
 protected:
 	UPROPERTY(Category=VillageSettings, EditDefaultsOnly, BlueprintReadOnly) 
 	float HousesCircleRadius = 1500.f;
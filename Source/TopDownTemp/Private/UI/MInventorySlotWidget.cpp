@@ -1,16 +1,116 @@
 #include "MInventorySlotWidget.h"
 #include "MInventoryWidget.h"
 #include "Characters/MCharacter.h"
+#include "Components/Image.h"
+#include "Components/RichTextBlock.h"
+#include "DataAssets/MItemsDataAsset.h"
 #include "Framework/MGameMode.h"
 #include "Managers/MDropManager.h"
 #include "Managers/MWorldGenerator.h"
 #include "StationaryActors/MActor.h"
 
+#if !UE_BUILD_SHIPPING
+int64 UMInventorySlotWidget::CreationsNumber = 0;
+int64 UMInventorySlotWidget::UpdatesNumber = 0;
+#endif
+
+void UMInventorySlotWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+#if !UE_BUILD_SHIPPING
+	++CreationsNumber;
+#endif
+}
+
 void UMInventorySlotWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 }
 
+void UMInventorySlotWidget::SetSlot(const UMInventoryComponent* IN_OwnerInventory, int IN_NumberInArray, const UMItemsDataAsset& ItemsDataAsset)
+{
+	if (!IsValid(IN_OwnerInventory) || !IN_OwnerInventory->GetSlots().IsValidIndex(IN_NumberInArray)) { check(false); return; }
+
+	if (OwnerInventory != IN_OwnerInventory || NumberInArray != IN_NumberInArray)
+	{
+		ResetSlot();
+		OwnerInventory = IN_OwnerInventory;
+		NumberInArray = IN_NumberInArray;
+		IN_OwnerInventory->GetSlotChangedDelegate(NumberInArray).AddDynamic(this, &UMInventorySlotWidget::OnSlotChanged);
+	}
+
+	const auto& Slot = IN_OwnerInventory->GetSlots()[NumberInArray];
+	StoredItem = Slot.Item;
+	if (DisplayedItem.IsSet() && DisplayedItem.GetValue() == Slot.Item)
+		return;
+
+	DisplayedItem = Slot.Item;
+#if !UE_BUILD_SHIPPING
+	++UpdatesNumber;
+#endif
+
+	const auto IconWidget = Cast<UImage>(GetWidgetFromName(TEXT("ItemIcon")));
+	const auto QuantityTextWidget = Cast<URichTextBlock>(GetWidgetFromName(TEXT("QuantityTextBlock")));
+	if (!IconWidget || !QuantityTextWidget)
+		return;
+
+	if (Slot.CheckFlag(FSlot::ESlotFlags::Secret))
+	{
+		IconWidget->SetBrushFromTexture(ItemsDataAsset.UnknownIconTexture);
+		IconWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+		QuantityTextWidget->SetVisibility(ESlateVisibility::Hidden);
+		return;
+	}
+
+	const auto& ItemsData = ItemsDataAsset.ItemsData;
+	if (Slot.Item.Quantity > 0 && Slot.Item.ID < ItemsData.Num() && Slot.Item.ID > 0)
+	{
+		// Item data is valid, don't draw quantity of a single item
+		IconWidget->SetBrushFromTexture(ItemsData[Slot.Item.ID].IconTexture);
+		IconWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+
+		QuantityTextWidget->SetText(FText::FromString(FString::FromInt(Slot.Item.Quantity)));
+		QuantityTextWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+	}
+	else // Slot is empty
+	{
+		IconWidget->SetVisibility(ESlateVisibility::Hidden);
+		QuantityTextWidget->SetVisibility(ESlateVisibility::Hidden);
+	}
+}
+
+void UMInventorySlotWidget::ResetSlot()
+{
+	if (IsValid(OwnerInventory) && OwnerInventory->GetSlots().IsValidIndex(NumberInArray))
+	{
+		OwnerInventory->GetSlotChangedDelegate(NumberInArray).RemoveDynamic(this, &UMInventorySlotWidget::OnSlotChanged);
+	}
+	OwnerInventory = nullptr;
+	DisplayedItem.Reset();
+}
+
+bool UMInventorySlotWidget::HasSameFlags(const FSlot& Slot) const
+{
+	return IsLocked == Slot.CheckFlag(FSlot::ESlotFlags::Locked) &&
+		IsSecret == Slot.CheckFlag(FSlot::ESlotFlags::Secret) &&
+		IsPreviewOnly == Slot.CheckFlag(FSlot::ESlotFlags::PreviewOnly);
+}
+
+void UMInventorySlotWidget::SetFlags(const FSlot& Slot)
+{
+	SetIsLocked(Slot.CheckFlag(FSlot::ESlotFlags::Locked));
+	SetIsSecret(Slot.CheckFlag(FSlot::ESlotFlags::Secret));
+	SetIsPreviewOnly(Slot.CheckFlag(FSlot::ESlotFlags::PreviewOnly));
+}
+
+void UMInventorySlotWidget::OnSlotChanged(int NewItemID, int NewQuantity)
+{
+	// The blueprint redraws the slot itself, remember it so the next SetSlot doesn't do it again
+	DisplayedItem = FItem{NewItemID, NewQuantity};
+	OnChangedData(NewItemID, NewQuantity);
+}
+
 FMUid UMInventorySlotWidget::GetOwnerInventoryActorUid() const
 {
 	check(OwnerInventory);
@@ -9,6 +9,7 @@
 class UMInventoryWidget;
 class UMInventoryComponent;
 class UMDropManager;
+class UMItemsDataAsset;
 
 UCLASS(Blueprintable, BlueprintType)
 class TOPDOWNTEMP_API UMInventorySlotWidget : public UUserWidget
@@ -16,8 +17,21 @@ class TOPDOWNTEMP_API UMInventorySlotWidget : public UUserWidget
 	GENERATED_BODY()
 
 public:
+	virtual void NativeOnInitialized() override;
+
 	virtual void NativeConstruct() override;
 
+	/** Shows the slot and listens to its changes. Cheap when the slot is already shown as it is, so it's fine to call on every inventory update */
+	void SetSlot(const UMInventoryComponent* IN_OwnerInventory, int IN_NumberInArray, const UMItemsDataAsset& ItemsDataAsset);
+
+	/** Stops listening to the slot, so the widget can be pooled and reused for another one */
+	void ResetSlot();
+
+	/** Locked, Secret and PreviewOnly are applied on construction, so a constructed widget can only show slots with the same flags */
+	bool HasSameFlags(const FSlot& Slot) const;
+
+	void SetFlags(const FSlot& Slot);
+
 	bool IsDraggingAWidget() const { return IsValid(DraggedWidget); }
 
 	void SetNumberInArray(int IN_NumberInArray) { NumberInArray = IN_NumberInArray; }
@@ -38,6 +52,9 @@ protected:
 	UFUNCTION(BlueprintCallable, Category=UMInventorySlotWidget)
 	FMUid GetOwnerInventoryActorUid() const;
 
+	UFUNCTION()
+	void OnSlotChanged(int NewItemID, int NewQuantity);
+
 	/** Number of the slot (container) in the wrap box, it doesn't change even if we swap items! */
 	UPROPERTY(BlueprintReadOnly, Category=UMInventorySlotWidget, meta=(AllowPrivateAccess=true))
 	int NumberInArray;
@@ -71,4 +88,16 @@ protected:
 	/** If the item does not have the frame and cannot be taken or interacted with in any way */
 	UPROPERTY(BlueprintReadOnly)
 	bool IsPreviewOnly = false;
+
+	/** What the icon and the quantity show now. Unset until the first SetSlot */
+	TOptional<FItem> DisplayedItem;
+
+public: // For debugging
+#if !UE_BUILD_SHIPPING
+	/** Slot widgets created since the last reset */
+	static int64 CreationsNumber;
+
+	/** Times the icon and the quantity were actually changed by SetSlot */
+	static int64 UpdatesNumber;
+#endif
 };
@@ -3,8 +3,6 @@
 #include "Managers/MDropManager.h"
 #include "Framework/MGameInstance.h"
 #include "MInventorySlotWidget.h"
-#include "Components/Image.h"
-#include "Components/RichTextBlock.h"
 #include "Components/WrapBox.h"
 #include "Components/MInventoryComponent.h"
 #include "Kismet/GameplayStatics.h"
@@ -22,21 +20,21 @@ void UMInventoryWidget::CreateSlots(const UMInventoryComponent* InventoryCompone
 	if (!pItemSlotsWrapBox)
 		return;
 
-	// Empty the list of items to create them form scratch
-	for ( int32 ChildIndex = pItemSlotsWrapBox->GetChildrenCount() - 1; ChildIndex >= 0; ChildIndex-- )
+	UpdateItemSlotWidgets(this, {InventoryComponent}, pItemSlotsWrapBox, SlotWidgetsPool);
+}
+
+namespace
+{
+	UMInventorySlotWidget* TakeSlotWidget(UUserWidget* pOwner, const FSlot& Slot, TArray<UMInventorySlotWidget*>& SlotWidgetsPool)
 	{
-		if (const auto InventorySlotWidget = Cast<UMInventorySlotWidget>(pItemSlotsWrapBox->GetChildAt(ChildIndex)))
+		// Flags are applied on construction, and pooled widgets are constructed again once added back
+		if (const auto SlotWidget = !SlotWidgetsPool.IsEmpty() ? SlotWidgetsPool.Pop(false) : CreateWidget<UMInventorySlotWidget>(pOwner, UMDropManager::gItemSlotWidgetBPClass))
 		{
-			if (InventorySlotWidget->IsDraggingAWidget())
-			{
-				InventorySlotWidget->SetVisibility(ESlateVisibility::Collapsed);
-				continue; // TODO: Also swap with the first item to boost the loop
-			}
+			SlotWidget->SetFlags(Slot);
+			return SlotWidget;
 		}
-		pItemSlotsWrapBox->RemoveChildAt(ChildIndex);
+		return nullptr;
 	}
-
-	CreateItemSlotWidgets(this, InventoryComponent, pItemSlotsWrapBox);
 }
 
 void UMInventoryWidget::CreateItemSlotWidgets(UUserWidget* pOwner, const UMInventoryComponent* pInventoryComponent,
@@ -54,62 +52,106 @@ void UMInventoryWidget::CreateItemSlotWidgets(UUserWidget* pOwner, const UMInven
 		return;
 	}
 
-	const auto ItemsData = pGameInstance->ItemsDataAsset->ItemsData;
-
 	// Create widgets for player's inventory slots
-	for (int Index = 0; Index < pInventoryComponent->GetSlotsConst().Num(); ++Index)
+	TArray<UMInventorySlotWidget*> NoPool;
+	for (int Index = 0; Index < pInventoryComponent->GetSlots().Num(); ++Index)
 	{
-		const auto& Slot = pInventoryComponent->GetSlotsConst()[Index];
-		const auto SlotWidget = CreateWidget<UMInventorySlotWidget>(pOwner, UMDropManager::gItemSlotWidgetBPClass);
-		if (!SlotWidget)
+		if (const auto SlotWidget = TakeSlotWidget(pOwner, pInventoryComponent->GetSlots()[Index], NoPool))
 		{
-			continue;
+			pItemSlotsWrapBox->AddChild(SlotWidget);
+			SlotWidget->SetSlot(pInventoryComponent, Index, *pGameInstance->ItemsDataAsset);
 		}
+	}
+}
+
+void UMInventoryWidget::UpdateItemSlotWidgets(UUserWidget* pOwner, const TArray<const UMInventoryComponent*>& Inventories,
+                                                 UWrapBox* pItemSlotsWrapBox, TArray<UMInventorySlotWidget*>& SlotWidgetsPool)
+{
+	if (!pItemSlotsWrapBox || !UMDropManager::gItemSlotWidgetBPClass)
+	{
+		check(false);
+		return;
+	}
+
+	const auto pGameInstance = pOwner->GetGameInstance<UMGameInstance>();
+	if (!pGameInstance || !pGameInstance->ItemsDataAsset)
+	{
+		return;
+	}
 
-		SlotWidget->SetNumberInArray(Index);
-		SlotWidget->SetOwnerInventory(pInventoryComponent);
-		SlotWidget->SetStoredItem(Slot.Item);
-		SlotWidget->SetIsLocked(Slot.CheckFlag(FSlot::ESlotFlags::Locked));
-		SlotWidget->SetIsSecret(Slot.CheckFlag(FSlot::ESlotFlags::Secret));
-		SlotWidget->SetIsPreviewOnly(Slot.CheckFlag(FSlot::ESlotFlags::PreviewOnly));
-		if (pInventoryComponent->GetOwner()->HasAuthority())
+	// Dragged widgets handle OnDrop(), OnDragCancelled(), etc. for the slot they were bound to, so they are kept collapsed
+	// at the end. The rest stay in order, each one bound to the slot of its index
+	int32 BoundChildrenNumber = pItemSlotsWrapBox->GetChildrenCount();
+	for (int32 i = BoundChildrenNumber - 1; i >= 0; --i)
+	{
+		const auto SlotWidget = Cast<UMInventorySlotWidget>(pItemSlotsWrapBox->GetChildAt(i));
+		if (!SlotWidget || (SlotWidget->GetVisibility() != ESlateVisibility::Collapsed && !SlotWidget->IsDraggingAWidget()))
+			continue;
+
+		if (SlotWidget->IsDraggingAWidget())
 		{
-			if (auto* InventoryComponentMutable = const_cast<UMInventoryComponent*>(pInventoryComponent))
-			{
-				auto& SlotMutable = InventoryComponentMutable->GetSlots()[Index];
-				SlotMutable.OnSlotChangedDelegate.RemoveDynamic(SlotWidget, &UMInventorySlotWidget::OnChangedData);
-				SlotMutable.OnSlotChangedDelegate.AddDynamic(SlotWidget, &UMInventorySlotWidget::OnChangedData);
-			}
+			SlotWidget->SetVisibility(ESlateVisibility::Collapsed);
+			pItemSlotsWrapBox->ShiftChild(pItemSlotsWrapBox->GetChildrenCount() - 1, SlotWidget);
 		}
+		else // Collapsed by an earlier update and the drag is over. The wrap box keeps the order it was added in, so don't reuse it in place
+		{
+			SlotWidget->SetVisibility(ESlateVisibility::Visible);
+			SlotWidget->ResetSlot();
+			SlotWidgetsPool.Add(SlotWidget);
+			pItemSlotsWrapBox->RemoveChildAt(i);
+		}
+		--BoundChildrenNumber;
+	}
+
+	int32 ChildIndex = 0;
+	for (const auto InventoryComponent : Inventories)
+	{
+		if (!IsValid(InventoryComponent))
+			continue;
 
-		const auto IconWidget = Cast<UImage>(SlotWidget->GetWidgetFromName(TEXT("ItemIcon")));
-		const auto QuantityTextWidget = Cast<URichTextBlock>(SlotWidget->GetWidgetFromName(TEXT("QuantityTextBlock")));
-		if (IconWidget && QuantityTextWidget) // Icon and QuantityText widgets exist
+		for (int Index = 0; Index < InventoryComponent->GetSlots().Num(); ++Index)
 		{
-			if (!Slot.CheckFlag(FSlot::ESlotFlags::Secret))
+			const auto& Slot = InventoryComponent->GetSlots()[Index];
+
+			auto SlotWidget = ChildIndex < BoundChildrenNumber ? Cast<UMInventorySlotWidget>(pItemSlotsWrapBox->GetChildAt(ChildIndex)) : nullptr;
+			if (!SlotWidget || !SlotWidget->HasSameFlags(Slot))
 			{
-				if (Slot.Item.Quantity > 0 && Slot.Item.ID < ItemsData.Num() && Slot.Item.ID > 0)
-				{
-					// Item data is valid, don't draw quantity of a single item
-					IconWidget->SetBrushFromTexture(ItemsData[Slot.Item.ID].IconTexture);
-					IconWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+				const auto NewSlotWidget = TakeSlotWidget(pOwner, Slot, SlotWidgetsPool);
+				if (!NewSlotWidget)
+					continue;
 
-					QuantityTextWidget->SetText(FText::FromString(FString::FromInt(Slot.Item.Quantity)));
-					QuantityTextWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+				if (ChildIndex < BoundChildrenNumber)
+				{
+					pItemSlotsWrapBox->ReplaceChildAt(ChildIndex, NewSlotWidget);
+					if (SlotWidget)
+					{
+						SlotWidget->ResetSlot();
+						SlotWidgetsPool.Add(SlotWidget);
+					}
 				}
-				else // Slot is empty
+				else
 				{
-					IconWidget->SetVisibility(ESlateVisibility::Hidden);
-					QuantityTextWidget->SetVisibility(ESlateVisibility::Hidden);
+					// Before the dragged ones. They are collapsed, so it doesn't matter where the wrap box shows it among them
+					pItemSlotsWrapBox->AddChild(NewSlotWidget);
+					pItemSlotsWrapBox->ShiftChild(ChildIndex, NewSlotWidget);
+					++BoundChildrenNumber;
 				}
+				SlotWidget = NewSlotWidget;
 			}
-			else
-			{
-				IconWidget->SetBrushFromTexture(pGameInstance->ItemsDataAsset->UnknownIconTexture);
-				IconWidget->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
-				QuantityTextWidget->SetVisibility(ESlateVisibility::Hidden);
-			}
+
+			SlotWidget->SetSlot(InventoryComponent, Index, *pGameInstance->ItemsDataAsset);
+			++ChildIndex;
+		}
+	}
+
+	// Remove the rest of the bound ones, the dragged ones after them stay
+	for (int32 i = BoundChildrenNumber - 1; i >= ChildIndex; --i)
+	{
+		if (const auto SlotWidget = Cast<UMInventorySlotWidget>(pItemSlotsWrapBox->GetChildAt(i)))
+		{
+			SlotWidget->ResetSlot();
+			SlotWidgetsPool.Add(SlotWidget);
 		}
-		pItemSlotsWrapBox->AddChild(SlotWidget);
+		pItemSlotsWrapBox->RemoveChildAt(i);
 	}
 }
@@ -6,6 +6,7 @@
 #include "MInventoryWidget.generated.h"
 
 class AMPickableActor;
+class UMInventorySlotWidget;
 class UWrapBox;
 
 //TODO: Scroll when the dragged item is near the top/bottom side of the scrollbox.
@@ -30,7 +31,18 @@ public:
 	static void CreateItemSlotWidgets(UUserWidget* pOwner, const UMInventoryComponent* pInventoryComponent,
 									  UWrapBox* pItemSlotsWrapBox);
 
+	/** Makes the wrap box show all the slots of the inventories in order.\n
+	 * Slot widgets already there are reused and redrawn only if their slot changed. Missing ones are taken from the pool
+	 * or created, extra ones go to the pool. Widgets being dragged are never removed, replaced or rebound,
+	 * they are collapsed and moved after the others until the drag is over, so the others keep their indices */
+	static void UpdateItemSlotWidgets(UUserWidget* pOwner, const TArray<const UMInventoryComponent*>& Inventories,
+									  UWrapBox* pItemSlotsWrapBox, TArray<UMInventorySlotWidget*>& SlotWidgetsPool);
+
 protected:
 	UPROPERTY(BlueprintReadWrite, Category=MInventoryWidgetSettings)
 	UWrapBox* pItemSlotsWrapBox;
+
+	/** Slot widgets removed from the wrap box, ready to be shown again */
+	UPROPERTY()
+	TArray<UMInventorySlotWidget*> SlotWidgetsPool;
 };
@@ -5,6 +5,7 @@
 #include "Components/MInventoryComponent.h"
 #include "MPickUpBarWidget.generated.h"
 
+class UMInventorySlotWidget;
 class UWrapBox;
 
 UCLASS()
@@ -29,5 +30,8 @@ protected:
 	UPROPERTY(BlueprintReadWrite, Category=MPickUpBarWidget)
 	UWrapBox* pItemSlotsWrapBox;
 
+	/** Slot widgets removed from the wrap box, ready to be shown again */
+	UPROPERTY()
+	TArray<UMInventorySlotWidget*> SlotWidgetsPool;
 
 };
\ No newline at end of file